@@ -45,16 +45,44 @@
 #define configUSE_PREEMPTION					1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
 #define configUSE_IDLE_HOOK						0
-#define configUSE_TICK_HOOK						0
+/* TMAN execution time budgets are checked from the tick hook (main.c), where
+the TMAN dispatcher can also run instead of in a task. */
+#ifndef TMAN_USE_BUDGET
+	#define TMAN_USE_BUDGET 0
+#endif
+#ifndef TMAN_USE_ISR_DISPATCHER
+	#define TMAN_USE_ISR_DISPATCHER 0
+#endif
+#define configUSE_TICK_HOOK						( TMAN_USE_BUDGET || TMAN_USE_ISR_DISPATCHER )
+/* TMAN microsecond time base on the core timer compare interrupt (main.c,
+tman_alarm_isr.S). */
+#ifndef TMAN_USE_HIRES_TIME
+	#define TMAN_USE_HIRES_TIME 0
+#endif
 #define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
 #define configCPU_CLOCK_HZ						( 80000000UL )
 #define configPERIPHERAL_CLOCK_HZ				( 40000000UL )
 #define configMAX_PRIORITIES					( 5UL )
 #define configMINIMAL_STACK_SIZE				( 190 )
 #define configISR_STACK_SIZE					( 250 )
-#define configTOTAL_HEAP_SIZE					( ( size_t ) 28000 )
+/* TMAN tasks and the kernel idle and timer tasks on static memory (main.c
+gives the kernel its part), which leaves the heap to the application. */
+#ifndef TMAN_USE_STATIC_ALLOCATION
+	#define TMAN_USE_STATIC_ALLOCATION 1
+#endif
+#define configSUPPORT_STATIC_ALLOCATION			TMAN_USE_STATIC_ALLOCATION
+#if TMAN_USE_STATIC_ALLOCATION
+	/* Stack pool for the six tasks of the demo table (mainSETRLedBlink.c):
+	6 x 190 words = 4560 bytes instead of 12160 for TMAN_MAX_TASKS. */
+	#ifndef TMAN_POOL_TASKS
+		#define TMAN_POOL_TASKS					6
+	#endif
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) 4096 )
+#else
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) 28000 )
+#endif
 #define configMAX_TASK_NAME_LEN					( 8 )
-#define configUSE_TRACE_FACILITY				0
+#define configUSE_TRACE_FACILITY				1
 #define configUSE_16_BIT_TICKS					0
 #define configIDLE_SHOULD_YIELD					1
 #define configUSE_MUTEXES						1
@@ -62,9 +90,9 @@
 #define configQUEUE_REGISTRY_SIZE				0
 #define configUSE_RECURSIVE_MUTEXES				1
 #define configUSE_MALLOC_FAILED_HOOK			1
-#define configUSE_APPLICATION_TASK_TAG			0
+#define configUSE_APPLICATION_TASK_TAG			1
 #define configUSE_COUNTING_SEMAPHORES			1
-#define configGENERATE_RUN_TIME_STATS			0
+#define configGENERATE_RUN_TIME_STATS			1
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 			0
@@ -88,11 +116,38 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay					1
 #define INCLUDE_uxTaskGetStackHighWaterMark	1
 #define INCLUDE_eTaskGetState				1
+#define INCLUDE_xTaskGetIdleTaskHandle		1
 
 /* Prevent C specific syntax being included in assembly files. */
 #ifndef __LANGUAGE_ASSEMBLY
 	void vAssertCalled( const char *pcFileName, unsigned long ulLine );
 	#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+	/* TMAN execution time accounting and event trace (tman.h). TMAN tasks
+	are tagged with their id + 1, the hooks run inside the context switch
+	with the kernel interrupts masked. */
+	void TMAN_TraceSwitchedIn( void *tag );
+	void TMAN_TraceSwitchedOut( void *tag );
+	#define traceTASK_SWITCHED_IN()		TMAN_TraceSwitchedIn( ( void * ) pxCurrentTCB->pxTaskTag )
+	#define traceTASK_SWITCHED_OUT()	TMAN_TraceSwitchedOut( ( void * ) pxCurrentTCB->pxTaskTag )
+
+	/* TMAN timestamps: the core timer counts at half the CPU clock. */
+	#define TMAN_TIMESTAMP()			_CP0_GET_COUNT()
+	#define TMAN_TIMESTAMP_HZ			( configCPU_CLOCK_HZ / 2 )
+
+	/* TMAN alarm: the compare register of the same counter (main.c). */
+	void vTmanAlarmSet( uint32_t ulStamp );
+	#define TMAN_ALARM_SET( stamp )		vTmanAlarmSet( stamp )
+
+	/* Kernel run time stats on the same free running counter, nothing to
+	set up. It wraps after 107 s, TMAN reports the CPU use between two
+	TMAN_TaskStats() calls. */
+	#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+	#define portGET_RUN_TIME_COUNTER_VALUE()	TMAN_TIMESTAMP()
+
+	#ifndef TMAN_USE_TRACE
+		#define TMAN_USE_TRACE 0
+	#endif
 #endif
 
 /* The priority at which the tick interrupt runs.  This should probably be
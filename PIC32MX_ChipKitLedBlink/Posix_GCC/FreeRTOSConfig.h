@@ -0,0 +1,159 @@
+/*
+ * FreeRTOS Kernel V10.4.4
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------
+ * Application specific definitions for the Linux host build of TMAN.
+ *
+ * The scheduling related values (tick rate, priorities) mirror the PIC32
+ * configuration in ../FreeRTOSConfig.h so that a task set behaves the same
+ * on the host and on the board. Stack sizes follow the POSIX port
+ * requirements (each task is a pthread).
+ *
+ * See http://www.freertos.org/a00110.html
+ *----------------------------------------------------------*/
+
+#define configUSE_PREEMPTION					1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION	0
+#define configUSE_IDLE_HOOK						1
+/* TMAN execution time budgets are checked from the tick hook (main.c),
+enabled with "make BUDGET=1". With "make ISR=1" the TMAN dispatcher runs
+there too, instead of in a task. */
+#ifndef TMAN_USE_BUDGET
+	#define TMAN_USE_BUDGET 0
+#endif
+#ifndef TMAN_USE_ISR_DISPATCHER
+	#define TMAN_USE_ISR_DISPATCHER 0
+#endif
+/* TMAN microsecond time base, enabled with "make HIRES=1". The host has no
+timer compare interrupt: the alarm is polled by the idle and tick hooks
+(main.c). */
+#ifndef TMAN_USE_HIRES_TIME
+	#define TMAN_USE_HIRES_TIME 0
+#endif
+#define configUSE_TICK_HOOK						( TMAN_USE_BUDGET || TMAN_USE_HIRES_TIME || TMAN_USE_ISR_DISPATCHER )
+#define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES					( 5UL )
+#define configMINIMAL_STACK_SIZE				( ( unsigned short ) PTHREAD_STACK_MIN )
+#define configTOTAL_HEAP_SIZE					( ( size_t ) ( 64 * 1024 ) )
+/* TMAN tasks and the kernel idle and timer tasks on static memory (main.c
+gives the kernel its part). */
+#ifndef TMAN_USE_STATIC_ALLOCATION
+	#define TMAN_USE_STATIC_ALLOCATION 1
+#endif
+#define configSUPPORT_STATIC_ALLOCATION			TMAN_USE_STATIC_ALLOCATION
+#define configMAX_TASK_NAME_LEN					( 12 )
+#define configUSE_TRACE_FACILITY				1
+#define configUSE_16_BIT_TICKS					0
+#define configIDLE_SHOULD_YIELD					1
+#define configUSE_MUTEXES						1
+#define configCHECK_FOR_STACK_OVERFLOW			0
+#define configQUEUE_REGISTRY_SIZE				0
+#define configUSE_RECURSIVE_MUTEXES				1
+#define configUSE_MALLOC_FAILED_HOOK			1
+#define configUSE_APPLICATION_TASK_TAG			1
+#define configUSE_COUNTING_SEMAPHORES			1
+#define configGENERATE_RUN_TIME_STATS			1
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES 			0
+#define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
+
+/* Software timer definitions. */
+#define configUSE_TIMERS				1
+#define configTIMER_TASK_PRIORITY		( 2 )
+#define configTIMER_QUEUE_LENGTH		5
+#define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE * 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+
+#define INCLUDE_vTaskPrioritySet			1
+#define INCLUDE_uxTaskPriorityGet			1
+#define INCLUDE_vTaskDelete					1
+#define INCLUDE_vTaskCleanUpResources		0
+#define INCLUDE_vTaskSuspend				1
+#define INCLUDE_vTaskDelayUntil				1
+#define INCLUDE_vTaskDelay					1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
+#define INCLUDE_eTaskGetState				1
+#define INCLUDE_xTaskGetIdleTaskHandle		1
+#define INCLUDE_xTaskGetSchedulerState		1
+
+/* Same assert hook as the board build, implemented in main.c. */
+void vAssertCalled( const char *pcFileName, unsigned long ulLine );
+#define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+/* TMAN output goes to stdout. printf() is not safe to call from several
+POSIX port threads at once, so it is wrapped by the console in main.c. */
+void vConsolePrintf( const char *pcFormat, ... );
+#define TMAN_PRINTF vConsolePrintf
+
+/* Stack depth of the TMAN tasks. Static stacks need a constant, which
+PTHREAD_STACK_MIN is not in every glibc build: the same 16384 words. */
+#define TMAN_STACK_SIZE		( 16384 )
+
+/* TMAN execution time accounting and event trace hooks, as on the board. */
+void TMAN_TraceSwitchedIn( void *tag );
+void TMAN_TraceSwitchedOut( void *tag );
+#define traceTASK_SWITCHED_IN()		TMAN_TraceSwitchedIn( ( void * ) pxCurrentTCB->pxTaskTag )
+#define traceTASK_SWITCHED_OUT()	TMAN_TraceSwitchedOut( ( void * ) pxCurrentTCB->pxTaskTag )
+
+/* TMAN timestamps: microseconds of the host monotonic clock (main.c). In
+virtual time the idle gaps are skipped, so release jitter is meaningless
+there; response and execution times are still measured while busy. */
+uint32_t ulTmanTimestamp( void );
+#define TMAN_TIMESTAMP()	ulTmanTimestamp()
+#define TMAN_TIMESTAMP_HZ	( 1000000UL )
+
+/* TMAN alarm on the same clock (main.c). */
+void vTmanAlarmSet( uint32_t ulStamp );
+#define TMAN_ALARM_SET( stamp )	vTmanAlarmSet( stamp )
+
+/* Kernel run time stats on the same clock (TMAN reports the CPU use
+between two TMAN_TaskStats() calls). In virtual time the skipped idle gaps
+are missing from the idle time. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()	ulTmanTimestamp()
+
+/* TMAN event trace, enabled with "make TRACE=1". The frames are written to
+stdout between the text messages (see ../tman_trace.h). */
+#ifndef TMAN_USE_TRACE
+#define TMAN_USE_TRACE 0
+#endif
+#if TMAN_USE_TRACE
+void vConsoleWrite( const void *pvData, size_t xLength );
+#define TMAN_TRACE_WRITE vConsoleWrite
+#endif
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,459 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN host simulation on the FreeRTOS POSIX port
+ * - Runs the same TMAN code (../tman.c) and task set as the ChipKit demo
+ * - TMAN output that goes to the UART on the board goes to stdout here
+ * - Optional virtual time: whenever the idle task runs the kernel tick is
+ *      advanced immediately, so idle time costs (almost) no wall-clock time
+ *      and hours of TMAN ticks can be pushed through in seconds
+ *
+ * - Optional aperiodic load: bursts of short event jobs run by a deferrable
+ *      server task 'S'
+ * - Optional mode changes: the task set alternates between the full set
+ *      (mode 'N') and a reduced one (mode 'R') at hyperperiod boundaries
+ *
+ * Usage: tman_posix [-t tman_ticks] [-v] [-a] [-m]
+ *      -t  stop after the given number of TMAN ticks and print the stats
+ *      -v  run in virtual (accelerated) time
+ *      -a  add the aperiodic server and its event bursts
+ *      -m  switch between the two modes every mainMODE_PERIOD TMAN ticks
+ *
+ * Built with "make TRACE=1" the TMAN event trace frames are written to
+ * stdout as well; decode them with "build/tman_trace" (make tools).
+ *
+ * Built with "make HIRES=1" a TMAN tick is mainTMAN_TICK_PERIOD
+ * microseconds, so the same task set runs with sub-millisecond periods;
+ * -t still counts TMAN ticks and -v is not available (TMAN time is the
+ * host clock).
+ *
+ * Environment:
+ * - GCC on Linux
+ * - FreeRTOS V202107.00 (kernel V10.4.4), POSIX port
+ *
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <time.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* App includes */
+#include "tman.h"
+
+#if TMAN_USE_HIRES_TIME
+/* TMAN tick period (in microseconds) and TMAN ticks to system ticks,
+rounded up */
+#define mainTMAN_TICK_PERIOD        ( 300 )
+#define mainTMAN_TICKS( x )         ( ( TickType_t ) ( ( ( uint64_t ) ( x ) * mainTMAN_TICK_PERIOD * configTICK_RATE_HZ + 999999 ) / 1000000 ) )
+#else
+/* TMAN tick period (in system ticks), same as the board demo */
+#define mainTMAN_TICK_PERIOD        ( 300 )
+#define mainTMAN_TICKS( x )         ( ( TickType_t ) ( x ) * mainTMAN_TICK_PERIOD )
+#endif
+
+/* The run monitor must preempt every TMAN task to stop the run on time */
+#define mainMONITOR_PRIORITY        ( configMAX_PRIORITIES - 1 )
+
+/* Aperiodic load: the event source stands for an interrupt handler, so it
+runs above every TMAN task (on the board it would call
+TMAN_ServerSubmitFromISR()). Each burst submits up to mainEVENT_BURST jobs of
+mainEVENT_JOB_US busy microseconds, a random time apart. */
+#define mainEVENT_PRIORITY          ( configMAX_PRIORITIES - 1 )
+#define mainEVENT_BURST             ( 6 )
+#define mainEVENT_MAX_GAP           mainTMAN_TICKS( 3 )
+
+/* Server budget per TMAN tick */
+#if TMAN_USE_HIRES_TIME
+#define mainEVENT_JOB_US            ( 10 )
+#define mainSERVER_BUDGET_US        ( 60 )
+#else
+#define mainEVENT_JOB_US            ( 500 )
+#define mainSERVER_BUDGET_US        ( 2000 )
+#endif
+
+/* Mode changes are requested from above the TMAN tasks, every
+mainMODE_PERIOD TMAN ticks. */
+#define mainMODE_PRIORITY           ( configMAX_PRIORITIES - 2 )
+#define mainMODE_PERIOD             ( 40 )
+
+static int xRunTmanTicks = 0;         // TMAN ticks to run (0 -> forever)
+static int xVirtualTime = 0;          // advance time when idle
+static int xAperiodic = 0;            // run the aperiodic load
+static int xModes = 0;                // alternate the modes
+static struct timespec xStartTime;    // wall-clock at scheduler start
+
+static void prvMonitorTask( void *pvParam );
+#if TMAN_MAX_SERVERS > 0
+static void prvEventTask( void *pvParam );
+static void prvEventJob( void *pvParam );
+#endif
+#if TMAN_MAX_MODES > 0
+static void prvModeTask( void *pvParam );
+#endif
+
+/*-----------------------------------------------------------*/
+
+int main( int argc, char *argv[] )
+{
+int iOption;
+
+    while( ( iOption = getopt( argc, argv, "t:vam" ) ) != -1 )
+    {
+        switch( iOption )
+        {
+            case 't':
+                xRunTmanTicks = atoi( optarg );
+                break;
+            case 'v':
+                xVirtualTime = 1;
+                break;
+            case 'a':
+                xAperiodic = 1;
+                break;
+            case 'm':
+                xModes = 1;
+                break;
+            default:
+                fprintf( stderr, "usage: %s [-t tman_ticks] [-v] [-a] [-m]\n", argv[ 0 ] );
+                return EXIT_FAILURE;
+        }
+    }
+
+#if TMAN_USE_HIRES_TIME
+    if( xVirtualTime != 0 )
+    {
+        fprintf( stderr, "%s: no virtual time with the high resolution time base\n", argv[ 0 ] );
+        xVirtualTime = 0;
+    }
+#endif
+
+    TMAN_Init(mainTMAN_TICK_PERIOD, xAperiodic ? 7 : 6);
+
+    TMAN_TaskAdd('A');
+    TMAN_TaskAdd('B');
+    TMAN_TaskAdd('C');
+    TMAN_TaskAdd('D');
+    TMAN_TaskAdd('E');
+    TMAN_TaskAdd('F');
+
+    int a_precedences[] = {5,-1,-1,-1,-1};
+    int b_precedences[] = {-1,-1,-1,-1,-1};
+    int c_precedences[] = {-1,-1,-1,-1,-1};
+    int d_precedences[] = {-1,-1,-1,-1,-1};
+    int e_precedences[] = {-1,-1,-1,-1,-1};
+    int f_precedences[] = {-1,-1,-1,-1,-1};
+
+    TMAN_TaskRegisterAttributes('A', tskIDLE_PRIORITY + 3, 2, 0, 2, a_precedences);
+    TMAN_TaskRegisterAttributes('B', tskIDLE_PRIORITY + 3, 1, 0, 1, b_precedences);
+    TMAN_TaskRegisterAttributes('C', tskIDLE_PRIORITY + 2, 3, 0, 3, c_precedences);
+    TMAN_TaskRegisterAttributes('D', tskIDLE_PRIORITY + 2, 3, 1, 3, d_precedences);
+    TMAN_TaskRegisterAttributes('E', tskIDLE_PRIORITY + 1, 5, 0, 5, e_precedences);
+    TMAN_TaskRegisterAttributes('F', tskIDLE_PRIORITY + 1, 5, 2, 5, f_precedences);
+
+#if TMAN_MAX_SERVERS > 0
+    if( xAperiodic != 0 )
+    {
+        /* Top of the TMAN band, one budget every TMAN tick. */
+        TMAN_ServerAdd('S', TMAN_SERVER_DEFERRABLE, mainSERVER_BUDGET_US);
+        TMAN_TaskRegisterAttributes('S', tskIDLE_PRIORITY + 3, 1, 0, 1, NULL);
+        xTaskCreate( prvEventTask, "EVENTS", configMINIMAL_STACK_SIZE, NULL, mainEVENT_PRIORITY, NULL );
+    }
+#endif
+
+#if TMAN_MAX_MODES > 0
+    if( xModes != 0 )
+    {
+        /* 'N' is the task set registered above, 'R' keeps A, B and C at
+        half the rate. */
+        TMAN_ModeAdd('N');
+        TMAN_ModeTask('N', 'A', tskIDLE_PRIORITY + 3, 2, 0, 2);
+        TMAN_ModeTask('N', 'B', tskIDLE_PRIORITY + 3, 1, 0, 1);
+        TMAN_ModeTask('N', 'C', tskIDLE_PRIORITY + 2, 3, 0, 3);
+        TMAN_ModeTask('N', 'D', tskIDLE_PRIORITY + 2, 3, 1, 3);
+        TMAN_ModeTask('N', 'E', tskIDLE_PRIORITY + 1, 5, 0, 5);
+        TMAN_ModeTask('N', 'F', tskIDLE_PRIORITY + 1, 5, 2, 5);
+
+        TMAN_ModeAdd('R');
+        TMAN_ModeTask('R', 'A', tskIDLE_PRIORITY + 3, 4, 0, 4);
+        TMAN_ModeTask('R', 'B', tskIDLE_PRIORITY + 3, 2, 0, 2);
+        TMAN_ModeTask('R', 'C', tskIDLE_PRIORITY + 2, 6, 1, 6);
+
+        xTaskCreate( prvModeTask, "MODES", configMINIMAL_STACK_SIZE, NULL, mainMODE_PRIORITY, NULL );
+    }
+#endif
+
+    if( xRunTmanTicks > 0 )
+    {
+        xTaskCreate( prvMonitorTask, "MONITOR", configMINIMAL_STACK_SIZE, NULL, mainMONITOR_PRIORITY, NULL );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+    vTaskStartScheduler();
+
+    TMAN_Close();
+
+    return EXIT_SUCCESS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMonitorTask( void *pvParam )
+{
+struct timespec xNow;
+double dWallSeconds;
+
+    ( void ) pvParam;
+
+    /* Let the task set run for the requested number of TMAN ticks. */
+    vTaskDelay( mainTMAN_TICKS( xRunTmanTicks ) );
+
+    vTaskSuspendAll();
+    {
+        clock_gettime( CLOCK_MONOTONIC, &xNow );
+        dWallSeconds = ( double ) ( xNow.tv_sec - xStartTime.tv_sec ) +
+                       ( double ) ( xNow.tv_nsec - xStartTime.tv_nsec ) / 1e9;
+
+        TMAN_TaskStats();
+        printf( "TMAN ticks = %d, kernel ticks = %lu, wall-clock = %.3f s%s\n",
+                TMAN_TICK, ( unsigned long ) xTaskGetTickCount(), dWallSeconds,
+                xVirtualTime ? " (virtual time)" : "" );
+        fflush( stdout );
+    }
+    exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+#if TMAN_MAX_SERVERS > 0
+
+static void prvEventTask( void *pvParam )
+{
+int iJobs;
+
+    ( void ) pvParam;
+
+    for( ;; )
+    {
+        vTaskDelay( 1 + rand() % mainEVENT_MAX_GAP );
+
+        iJobs = 1 + rand() % mainEVENT_BURST;
+        while( iJobs-- > 0 )
+        {
+            TMAN_ServerSubmit( 'S', prvEventJob, NULL );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvEventJob( void *pvParam )
+{
+uint32_t ulStart = ulTmanTimestamp();
+
+    ( void ) pvParam;
+
+    while( ulTmanTimestamp() - ulStart < mainEVENT_JOB_US )
+    {
+    }
+}
+/*-----------------------------------------------------------*/
+
+#endif /* TMAN_MAX_SERVERS > 0 */
+
+#if TMAN_MAX_MODES > 0
+
+static void prvModeTask( void *pvParam )
+{
+    ( void ) pvParam;
+
+    for( ;; )
+    {
+        vTaskDelay( mainTMAN_TICKS( mainMODE_PERIOD ) );
+        TMAN_ModeChange( TMAN_ModeCurrent() == 'R' ? 'N' : 'R', TMAN_MODE_HYPERPERIOD );
+    }
+}
+/*-----------------------------------------------------------*/
+
+#endif /* TMAN_MAX_MODES > 0 */
+
+void vConsolePrintf( const char *pcFormat, ... )
+{
+va_list xArgs;
+
+    if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+    {
+        va_start( xArgs, pcFormat );
+        vprintf( pcFormat, xArgs );
+        va_end( xArgs );
+        return;
+    }
+
+    /* Threads of the POSIX port are switched by a signal; keep the kernel
+    from switching away while stdout is locked by printf(). */
+    vTaskSuspendAll();
+    {
+        va_start( xArgs, pcFormat );
+        vprintf( pcFormat, xArgs );
+        va_end( xArgs );
+        fflush( stdout );
+    }
+    xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulTmanTimestamp( void )
+{
+struct timespec xNow;
+
+    /* Called from the context switch too; clock_gettime() is
+    async-signal-safe. */
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( uint32_t ) ( ( uint64_t ) xNow.tv_sec * 1000000u + xNow.tv_nsec / 1000 );
+}
+/*-----------------------------------------------------------*/
+
+void vConsoleWrite( const void *pvData, size_t xLength )
+{
+    /* Raw bytes (trace frames), same locking as vConsolePrintf(). */
+    vTaskSuspendAll();
+    {
+        fwrite( pvData, 1, xLength, stdout );
+        fflush( stdout );
+    }
+    xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+#if TMAN_USE_HIRES_TIME
+
+static volatile uint32_t ulAlarmStamp;   // TMAN alarm (ulTmanTimestamp() units)
+static volatile int xAlarmArmed;
+
+void vTmanAlarmSet( uint32_t ulStamp )
+{
+    /* Only the TMAN dispatcher arms the alarm. Disarmed while the stamp
+    changes, for the hooks that may interrupt it. */
+    xAlarmArmed = 0;
+    ulAlarmStamp = ulStamp;
+    xAlarmArmed = 1;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTmanAlarmPoll( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    /* What the timer compare interrupt does on the board, once the clock
+    has reached the alarm. Called with the kernel interrupts masked. */
+    if( xAlarmArmed != 0 && ( int32_t ) ( ulTmanTimestamp() - ulAlarmStamp ) >= 0 )
+    {
+        xAlarmArmed = 0;
+        TMAN_AlarmFromISR( &xHigherPriorityTaskWoken );
+    }
+
+    return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* TMAN_USE_HIRES_TIME */
+
+void vApplicationIdleHook( void )
+{
+#if TMAN_USE_HIRES_TIME
+BaseType_t xHigherPriorityTaskWoken;
+
+    /* The idle task keeps polling the TMAN alarm, so it fires within
+    microseconds while the CPU is idle; while TMAN tasks run, the tick hook
+    catches it within a kernel tick. */
+    taskENTER_CRITICAL();
+    {
+        xHigherPriorityTaskWoken = prvTmanAlarmPoll();
+    }
+    taskEXIT_CRITICAL();
+
+    if( xHigherPriorityTaskWoken != pdFALSE )
+    {
+        taskYIELD();
+    }
+#endif
+
+    /* Nothing is ready to run, so the time until the next tick would only
+    be spent idling: account it right away. Advancing one tick at a time
+    keeps every blocked task waking up exactly at its own tick. */
+    if( xVirtualTime != 0 )
+    {
+        xTaskCatchUpTicks( 1 );
+
+#if TMAN_USE_ISR_DISPATCHER
+        /* The kernel does not call the tick hook for the ticks caught up,
+        so the TMAN ticks they complete are dispatched from here. */
+        taskENTER_CRITICAL();
+        {
+            TMAN_TickHook();
+        }
+        taskEXIT_CRITICAL();
+        taskYIELD();
+#endif
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationTickHook( void )
+{
+    /* TMAN execution time budgets or dispatcher (configUSE_TICK_HOOK
+    follows TMAN_USE_BUDGET, TMAN_USE_HIRES_TIME and
+    TMAN_USE_ISR_DISPATCHER). */
+    TMAN_TickHook();
+
+#if TMAN_USE_HIRES_TIME
+    /* Late alarms; the dispatcher runs when the tick interrupt returns. */
+    ( void ) prvTmanAlarmPoll();
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+
+/* Kernel idle and timer tasks, on stacks as deep as the TMAN ones
+(configMINIMAL_STACK_SIZE may not be a constant here). */
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+{
+static StaticTask_t xIdleTaskTCB;
+static StackType_t uxIdleTaskStack[ TMAN_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = TMAN_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+{
+static StaticTask_t xTimerTaskTCB;
+static StackType_t uxTimerTaskStack[ TMAN_STACK_SIZE ];
+
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = TMAN_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+void vApplicationMallocFailedHook( void )
+{
+    fprintf( stderr, "malloc failed\n" );
+    exit( EXIT_FAILURE );
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile, unsigned long ulLine )
+{
+    fprintf( stderr, "ASSERT! %s:%lu\n", pcFile, ulLine );
+    abort();
+}
@@ -57,17 +57,17 @@ OBJECTDIR=build/${CND_CONF}/${IMAGE_TYPE}
 DISTDIR=dist/${CND_CONF}/${IMAGE_TYPE}
 
 # Source Files Quoted if spaced
-SOURCEFILES_QUOTED_IF_SPACED=../../../Source/portable/MPLAB/PIC32MX/port.c ../../../Source/portable/MPLAB/PIC32MX/port_asm.S ../../../Source/queue.c ../../../Source/tasks.c ../../../Source/list.c ../../../Source/timers.c ../../../Source/portable/MemMang/heap_4.c ../main.c ../ConfigPerformance.c ../mainSETRLedBlink.c ../../UART/uart.c
+SOURCEFILES_QUOTED_IF_SPACED=../../../Source/portable/MPLAB/PIC32MX/port.c ../../../Source/portable/MPLAB/PIC32MX/port_asm.S ../../../Source/queue.c ../../../Source/tasks.c ../../../Source/list.c ../../../Source/timers.c ../../../Source/portable/MemMang/heap_4.c ../main.c ../ConfigPerformance.c ../mainSETRLedBlink.c ../tman.c ../tman_alarm_isr.S ../../UART/uart.c
 
 # Object Files Quoted if spaced
-OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/332309696/port.o ${OBJECTDIR}/_ext/332309696/port_asm.o ${OBJECTDIR}/_ext/449926602/queue.o ${OBJECTDIR}/_ext/449926602/tasks.o ${OBJECTDIR}/_ext/449926602/list.o ${OBJECTDIR}/_ext/449926602/timers.o ${OBJECTDIR}/_ext/1884096877/heap_4.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/ConfigPerformance.o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ${OBJECTDIR}/_ext/1852901230/uart.o
-POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/332309696/port.o.d ${OBJECTDIR}/_ext/332309696/port_asm.o.d ${OBJECTDIR}/_ext/449926602/queue.o.d ${OBJECTDIR}/_ext/449926602/tasks.o.d ${OBJECTDIR}/_ext/449926602/list.o.d ${OBJECTDIR}/_ext/449926602/timers.o.d ${OBJECTDIR}/_ext/1884096877/heap_4.o.d ${OBJECTDIR}/_ext/1472/main.o.d ${OBJECTDIR}/_ext/1472/ConfigPerformance.o.d ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o.d ${OBJECTDIR}/_ext/1852901230/uart.o.d
+OBJECTFILES_QUOTED_IF_SPACED=${OBJECTDIR}/_ext/332309696/port.o ${OBJECTDIR}/_ext/332309696/port_asm.o ${OBJECTDIR}/_ext/449926602/queue.o ${OBJECTDIR}/_ext/449926602/tasks.o ${OBJECTDIR}/_ext/449926602/list.o ${OBJECTDIR}/_ext/449926602/timers.o ${OBJECTDIR}/_ext/1884096877/heap_4.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/ConfigPerformance.o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ${OBJECTDIR}/_ext/1472/tman.o ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o ${OBJECTDIR}/_ext/1852901230/uart.o
+POSSIBLE_DEPFILES=${OBJECTDIR}/_ext/332309696/port.o.d ${OBJECTDIR}/_ext/332309696/port_asm.o.d ${OBJECTDIR}/_ext/449926602/queue.o.d ${OBJECTDIR}/_ext/449926602/tasks.o.d ${OBJECTDIR}/_ext/449926602/list.o.d ${OBJECTDIR}/_ext/449926602/timers.o.d ${OBJECTDIR}/_ext/1884096877/heap_4.o.d ${OBJECTDIR}/_ext/1472/main.o.d ${OBJECTDIR}/_ext/1472/ConfigPerformance.o.d ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o.d ${OBJECTDIR}/_ext/1472/tman.o.d ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d ${OBJECTDIR}/_ext/1852901230/uart.o.d
 
 # Object Files
-OBJECTFILES=${OBJECTDIR}/_ext/332309696/port.o ${OBJECTDIR}/_ext/332309696/port_asm.o ${OBJECTDIR}/_ext/449926602/queue.o ${OBJECTDIR}/_ext/449926602/tasks.o ${OBJECTDIR}/_ext/449926602/list.o ${OBJECTDIR}/_ext/449926602/timers.o ${OBJECTDIR}/_ext/1884096877/heap_4.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/ConfigPerformance.o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ${OBJECTDIR}/_ext/1852901230/uart.o
+OBJECTFILES=${OBJECTDIR}/_ext/332309696/port.o ${OBJECTDIR}/_ext/332309696/port_asm.o ${OBJECTDIR}/_ext/449926602/queue.o ${OBJECTDIR}/_ext/449926602/tasks.o ${OBJECTDIR}/_ext/449926602/list.o ${OBJECTDIR}/_ext/449926602/timers.o ${OBJECTDIR}/_ext/1884096877/heap_4.o ${OBJECTDIR}/_ext/1472/main.o ${OBJECTDIR}/_ext/1472/ConfigPerformance.o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ${OBJECTDIR}/_ext/1472/tman.o ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o ${OBJECTDIR}/_ext/1852901230/uart.o
 
 # Source Files
-SOURCEFILES=../../../Source/portable/MPLAB/PIC32MX/port.c ../../../Source/portable/MPLAB/PIC32MX/port_asm.S ../../../Source/queue.c ../../../Source/tasks.c ../../../Source/list.c ../../../Source/timers.c ../../../Source/portable/MemMang/heap_4.c ../main.c ../ConfigPerformance.c ../mainSETRLedBlink.c ../../UART/uart.c
+SOURCEFILES=../../../Source/portable/MPLAB/PIC32MX/port.c ../../../Source/portable/MPLAB/PIC32MX/port_asm.S ../../../Source/queue.c ../../../Source/tasks.c ../../../Source/list.c ../../../Source/timers.c ../../../Source/portable/MemMang/heap_4.c ../main.c ../ConfigPerformance.c ../mainSETRLedBlink.c ../tman.c ../tman_alarm_isr.S ../../UART/uart.c
 
 
 
@@ -109,6 +109,14 @@ ${OBJECTDIR}/_ext/332309696/port_asm.o: ../../../Source/portable/MPLAB/PIC32MX/p
 	${MP_CC} $(MP_EXTRA_AS_PRE)  -D__DEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -c -mprocessor=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/332309696/port_asm.o.d"  -o ${OBJECTDIR}/_ext/332309696/port_asm.o ../../../Source/portable/MPLAB/PIC32MX/port_asm.S  -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    -Wa,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_AS_POST),-MD="${OBJECTDIR}/_ext/332309696/port_asm.o.asm.d",--defsym=__MPLAB_DEBUG=1,--gdwarf-2,--defsym=__DEBUG=1,--defsym=__MPLAB_DEBUGGER_SIMULATOR=1 -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../ 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/332309696/port_asm.o.d" "${OBJECTDIR}/_ext/332309696/port_asm.o.asm.d" -t $(SILENT) -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/1472/tman_alarm_isr.o: ../tman_alarm_isr.S  .generated_files/flags/USB-II_STARTER_KIT/53447e52d3e1a76404a047f71329589582ee4326 .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
+	@${MKDIR} "${OBJECTDIR}/_ext/1472" 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.ok ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.err 
+	${MP_CC} $(MP_EXTRA_AS_PRE)  -D__DEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1 -c -mprocessor=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d"  -o ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o ../tman_alarm_isr.S  -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    -Wa,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_AS_POST),-MD="${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.asm.d",--defsym=__MPLAB_DEBUG=1,--gdwarf-2,--defsym=__DEBUG=1,--defsym=__MPLAB_DEBUGGER_SIMULATOR=1 -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../ 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d" "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.asm.d" -t $(SILENT) -rsi ${MP_CC_DIR}../ 
+	
 else
 ${OBJECTDIR}/_ext/332309696/port_asm.o: ../../../Source/portable/MPLAB/PIC32MX/port_asm.S  .generated_files/flags/USB-II_STARTER_KIT/cbba8a73d8f88f42bdbbd98bc156b672835e23d9 .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
 	@${MKDIR} "${OBJECTDIR}/_ext/332309696" 
@@ -118,6 +126,14 @@ ${OBJECTDIR}/_ext/332309696/port_asm.o: ../../../Source/portable/MPLAB/PIC32MX/p
 	${MP_CC} $(MP_EXTRA_AS_PRE)  -c -mprocessor=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/332309696/port_asm.o.d"  -o ${OBJECTDIR}/_ext/332309696/port_asm.o ../../../Source/portable/MPLAB/PIC32MX/port_asm.S  -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    -Wa,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_AS_POST),-MD="${OBJECTDIR}/_ext/332309696/port_asm.o.asm.d",--gdwarf-2 -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../ 
 	@${FIXDEPS} "${OBJECTDIR}/_ext/332309696/port_asm.o.d" "${OBJECTDIR}/_ext/332309696/port_asm.o.asm.d" -t $(SILENT) -rsi ${MP_CC_DIR}../ 
 	
+${OBJECTDIR}/_ext/1472/tman_alarm_isr.o: ../tman_alarm_isr.S  .generated_files/flags/USB-II_STARTER_KIT/ca5e7f6ce5a6c348283f9a14b6ffc3daacad76bb .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
+	@${MKDIR} "${OBJECTDIR}/_ext/1472" 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.ok ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.err 
+	${MP_CC} $(MP_EXTRA_AS_PRE)  -c -mprocessor=$(MP_PROCESSOR_OPTION)  -MMD -MF "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d"  -o ${OBJECTDIR}/_ext/1472/tman_alarm_isr.o ../tman_alarm_isr.S  -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    -Wa,--defsym=__MPLAB_BUILD=1$(MP_EXTRA_AS_POST),-MD="${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.asm.d",--gdwarf-2 -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../ 
+	@${FIXDEPS} "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.d" "${OBJECTDIR}/_ext/1472/tman_alarm_isr.o.asm.d" -t $(SILENT) -rsi ${MP_CC_DIR}../ 
+	
 endif
 
 # ------------------------------------------------------------------------------------
@@ -177,6 +193,12 @@ ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o: ../mainSETRLedBlink.c  .generated_fil
 	@${RM} ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o 
 	${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -fno-common -DPIC32_STARTER_KIT -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGPORT_WARNING -MP -MMD -MF "${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o.d" -o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ../mainSETRLedBlink.c    -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    $(COMPARISON_BUILD)  -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../   
 	
+${OBJECTDIR}/_ext/1472/tman.o: ../tman.c  .generated_files/flags/USB-II_STARTER_KIT/5029e8916c98f3b5c4976efdd6f05f003aaad8b8 .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
+	@${MKDIR} "${OBJECTDIR}/_ext/1472" 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman.o 
+	${MP_CC}  $(MP_EXTRA_CC_PRE) -g -D__DEBUG -D__MPLAB_DEBUGGER_SIMULATOR=1  -fframe-base-loclist  -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -fno-common -DPIC32_STARTER_KIT -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGPORT_WARNING -MP -MMD -MF "${OBJECTDIR}/_ext/1472/tman.o.d" -o ${OBJECTDIR}/_ext/1472/tman.o ../tman.c    -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    $(COMPARISON_BUILD)  -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../   
+	
 ${OBJECTDIR}/_ext/1852901230/uart.o: ../../UART/uart.c  .generated_files/flags/USB-II_STARTER_KIT/1720e89d5bffb44dbafd7ece7d039f3d4c65a8ce .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
 	@${MKDIR} "${OBJECTDIR}/_ext/1852901230" 
 	@${RM} ${OBJECTDIR}/_ext/1852901230/uart.o.d 
@@ -238,6 +260,12 @@ ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o: ../mainSETRLedBlink.c  .generated_fil
 	@${RM} ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o 
 	${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -fno-common -DPIC32_STARTER_KIT -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGPORT_WARNING -MP -MMD -MF "${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o.d" -o ${OBJECTDIR}/_ext/1472/mainSETRLedBlink.o ../mainSETRLedBlink.c    -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    $(COMPARISON_BUILD)  -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../   
 	
+${OBJECTDIR}/_ext/1472/tman.o: ../tman.c  .generated_files/flags/USB-II_STARTER_KIT/0c54df66baff02e6f184ce254dd9a9dce31b4fb3 .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
+	@${MKDIR} "${OBJECTDIR}/_ext/1472" 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman.o.d 
+	@${RM} ${OBJECTDIR}/_ext/1472/tman.o 
+	${MP_CC}  $(MP_EXTRA_CC_PRE)  -g -x c -c -mprocessor=$(MP_PROCESSOR_OPTION)  -fno-common -DPIC32_STARTER_KIT -D_SUPPRESS_PLIB_WARNING -D_DISABLE_OPENADC10_CONFIGPORT_WARNING -MP -MMD -MF "${OBJECTDIR}/_ext/1472/tman.o.d" -o ${OBJECTDIR}/_ext/1472/tman.o ../tman.c    -DXPRJ_USB-II_STARTER_KIT=$(CND_CONF)    $(COMPARISON_BUILD)  -I ../../../Source/include -I ../../../Source/portable/MPLAB/PIC32MX -I ../../Common/include -I ../   
+	
 ${OBJECTDIR}/_ext/1852901230/uart.o: ../../UART/uart.c  .generated_files/flags/USB-II_STARTER_KIT/e7997b9b1cd80afda1d06db757f779aeca1be408 .generated_files/flags/USB-II_STARTER_KIT/d55f73a18bf11a00a687ff00baaa9b44bb96546
 	@${MKDIR} "${OBJECTDIR}/_ext/1852901230" 
 	@${RM} ${OBJECTDIR}/_ext/1852901230/uart.o.d 
@@ -0,0 +1,43 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * Simulated kernel of the TMAN schedule simulator (../tman_sim.c)
+ * - The part of the FreeRTOS API that tman.c calls, same names and types,
+ *      so tman.c builds unchanged against it
+ * - One thread: the simulator plays the tasks, critical sections and
+ *      scheduler locks are empty
+ *
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uintptr_t StackType_t;
+
+#include "FreeRTOSConfig.h"
+
+#define pdFALSE             ( ( BaseType_t ) 0 )
+#define pdTRUE              ( ( BaseType_t ) 1 )
+#define pdPASS              ( pdTRUE )
+#define pdFAIL              ( pdFALSE )
+
+#define portMAX_DELAY       ( ( TickType_t ) 0xffffffffUL )
+#define portYIELD_FROM_ISR( x )     ( ( void ) ( x ) )
+
+/* Memory of a static task, never used: the simulated tasks have none */
+typedef struct xSTATIC_TCB {
+    void *pxDummy;
+} StaticTask_t;
+
+#ifndef configASSERT
+#define configASSERT( x )
+#endif
+
+#endif /* INC_FREERTOS_H */
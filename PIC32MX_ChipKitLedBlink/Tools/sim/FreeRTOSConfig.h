@@ -0,0 +1,49 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * Configuration of the TMAN schedule simulator. The kernel tick rate is
+ * the board's, so TMAN ticks of the same number of kernel ticks last as
+ * long; there are more priorities, for task sets larger than the demo.
+ * Other TMAN options (TMAN_USE_EDF, TMAN_USE_TIME_TRIGGERED, ...) can be
+ * given on the compiler command line.
+ *
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+#define configTICK_RATE_HZ              ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES            ( 32UL )
+#define configMINIMAL_STACK_SIZE        ( 128 )
+/* Equal priorities share the processor, switched at every kernel tick */
+#define configUSE_TIME_SLICING          1
+#define configSUPPORT_STATIC_ALLOCATION 0
+#define configUSE_TICK_HOOK             0
+#define configUSE_TRACE_FACILITY        0
+#define configGENERATE_RUN_TIME_STATS   0
+#define INCLUDE_uxTaskGetStackHighWaterMark 0
+
+void vSimAssert( const char *pcFileName, unsigned long ulLine );
+#define configASSERT( x ) if( ( x ) == 0 ) vSimAssert( __FILE__, __LINE__ )
+
+/* TMAN in the simulator: no dispatcher or logger task */
+#define TMAN_USE_SIMULATION     1
+#define TMAN_USE_DEFERRED_LOG   0
+#define TMAN_MAX_SERVERS        0
+#ifndef TMAN_MAX_TASKS
+#define TMAN_MAX_TASKS          32
+#endif
+
+/* Messages go to stdout, the job log only when asked for (-v) */
+void vSimPrintf( const char *pcFormat, ... );
+#define TMAN_PRINTF vSimPrintf
+
+/* Timestamps: microseconds of simulated time */
+uint32_t ulSimTimestamp( void );
+#define TMAN_TIMESTAMP()    ulSimTimestamp()
+#define TMAN_TIMESTAMP_HZ   ( 1000000UL )
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,15 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * Simulated kernel of the TMAN schedule simulator: no queues (they only
+ * serve the aperiodic servers, which are not simulated)
+ *
+ */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "FreeRTOS.h"
+
+#endif /* QUEUE_H */
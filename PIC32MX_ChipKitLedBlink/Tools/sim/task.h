@@ -0,0 +1,49 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * Simulated kernel of the TMAN schedule simulator: task API
+ *
+ */
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+#define tskIDLE_PRIORITY    ( ( UBaseType_t ) 0U )
+
+struct tskTaskControlBlock;
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)( void * );
+typedef BaseType_t (*TaskHookFunction_t)( void * );
+
+/* Nothing runs concurrently with the simulated dispatcher */
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskENTER_CRITICAL_FROM_ISR()   ( ( UBaseType_t ) 0 )
+#define taskEXIT_CRITICAL_FROM_ISR( x ) ( ( void ) ( x ) )
+#define taskYIELD()
+
+/* Tasks: created ready to be handed jobs, never run by the kernel */
+BaseType_t xTaskCreate( TaskFunction_t pxTaskCode, const char * const pcName, uint32_t usStackDepth,
+        void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask );
+void vTaskDelete( TaskHandle_t xTaskToDelete );
+void vTaskPrioritySet( TaskHandle_t xTask, UBaseType_t uxNewPriority );
+UBaseType_t uxTaskPriorityGet( TaskHandle_t xTask );
+void vTaskSetApplicationTaskTag( TaskHandle_t xTask, TaskHookFunction_t pxHookFunction );
+TaskHookFunction_t xTaskGetApplicationTaskTag( TaskHandle_t xTask );
+TaskHandle_t xTaskGetCurrentTaskHandle( void );
+
+/* A notification is a job handed to a task */
+BaseType_t xTaskNotifyGive( TaskHandle_t xTaskToNotify );
+void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken );
+uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait );
+
+TickType_t xTaskGetTickCount( void );
+TickType_t xTaskGetTickCountFromISR( void );
+void vTaskSuspendAll( void );
+BaseType_t xTaskResumeAll( void );
+void vTaskEndScheduler( void );
+
+#endif /* INC_TASK_H */
@@ -0,0 +1,84 @@
+#!/bin/sh
+#
+# Rodrigo Santos , nº mec 89180
+# Rui Santos, nº mec 89293
+#
+# TMAN schedulability benchmark (host tool)
+# - For every task count and total utilization, generates task sets with
+#      tman_gen and runs them through tman_sim
+# - One row per task count and utilization: sets simulated, sets without
+#      a deadline miss, ratio of missed deadlines to released jobs, mean host
+#      time of the dispatcher per TMAN tick, largest response / deadline,
+#      and the response / deadline histogram in percent of the jobs (late
+#      jobs last)
+#
+# Usage: tman_bench.sh [-n counts] [-u utilizations] [-k sets] [-t ticks]
+#                      [-b bindir] [-- tman_gen options]
+#      -n  task counts (default "4 8 16")
+#      -u  utilizations (default "0.5 0.6 0.7 0.8 0.9 1.0")
+#      -k  task sets per row, seeds 1 to k (default 20)
+#      -t  TMAN ticks simulated per set (default 100000)
+#      -b  directory of tman_gen and tman_sim (default ../Posix_GCC/build,
+#          see "make tools" there)
+#
+# Example, harmonic periods and a precedence density of 0.2:
+#
+#   ./tman_bench.sh -n "8 16" -- -d h -c 0.2
+#
+
+COUNTS="4 8 16"
+UTILIZATIONS="0.5 0.6 0.7 0.8 0.9 1.0"
+SETS=20
+TICKS=100000
+BIN="$(dirname "$0")/../Posix_GCC/build"
+
+while getopts "n:u:k:t:b:" option; do
+    case $option in
+        n) COUNTS=$OPTARG ;;
+        u) UTILIZATIONS=$OPTARG ;;
+        k) SETS=$OPTARG ;;
+        t) TICKS=$OPTARG ;;
+        b) BIN=$OPTARG ;;
+        *) echo "usage: $0 [-n counts] [-u utilizations] [-k sets] [-t ticks] [-b bindir] [-- tman_gen options]" >&2
+           exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ ! -x "$BIN/tman_gen" ] || [ ! -x "$BIN/tman_sim" ]; then
+    echo "$0: tman_gen and tman_sim not found in $BIN" >&2
+    exit 1
+fi
+
+TASKSET=$(mktemp) || exit 1
+trap 'rm -f "$TASKSET"' EXIT
+
+printf "%5s %5s %5s %5s %9s %9s %7s  %s\n" TASKS UTIL SETS OK MISSES DISP_NS R/D_MAX "RESPONSE / DEADLINE (%)"
+for n in $COUNTS; do
+    for u in $UTILIZATIONS; do
+        s=1
+        while [ "$s" -le "$SETS" ]; do
+            "$BIN/tman_gen" -n "$n" -u "$u" -s "$s" "$@" > "$TASKSET" || exit 1
+            # Exit status 2 only tells about the misses, counted below
+            "$BIN/tman_sim" -b -t "$TICKS" "$TASKSET"
+            s=$((s + 1))
+        done | awk -v n="$n" -v u="$u" '
+            $1 == "BENCH" {
+                sets++
+                if ($4 == 0) ok++
+                activations += $3
+                misses += $4
+                jobs += $5
+                ns += $6
+                if ($7 > ratio) ratio = $7
+                for (i = 8; i <= NF; i++) h[i] += $i
+                last = NF
+            }
+            END {
+                printf "%5d %5.2f %5d %5d %9.6f %9.0f %7.3f ", n, u, sets, ok,
+                    activations ? misses / activations : 0, sets ? ns / sets : 0, ratio / 1000
+                for (i = 8; i <= last; i++) printf " %5.1f", jobs ? 100 * h[i] / jobs : 0
+                printf "\n"
+            }'
+    done
+done
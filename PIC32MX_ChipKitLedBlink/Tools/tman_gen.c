@@ -0,0 +1,237 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN task set generator (host tool)
+ * - Writes a random task set in the task file format of tman_sim
+ * - Task utilizations drawn with UUniFast (uniform over the sets of the
+ *      given total), periods from a uniform, log-uniform or harmonic
+ *      distribution, execution time = utilization * period
+ * - Deadline monotonic priorities, deadlines implicit or constrained, all
+ *      the tasks released at tick 0 (the critical instant)
+ * - Random precedence graph of a given density (acyclic: an edge only goes
+ *      from a task to one generated after it)
+ *
+ * Usage: tman_gen [-n tasks] [-u utilization] [-p min-max] [-d u|l|h]
+ *                 [-c density] [-D fraction] [-j fraction] [-P priority]
+ *                 [-t tick_us] [-s seed]
+ *      -n  number of tasks (default 8, at most 32 as in tman_sim)
+ *      -u  total utilization (default 0.5)
+ *      -p  period range in TMAN ticks (default 10-1000)
+ *      -d  period distribution: uniform, log-uniform (default) or
+ *          harmonic (the minimum times a power of two)
+ *      -c  probability of a precedence edge between two tasks (default 0)
+ *      -D  deadlines drawn between fraction * period and the period
+ *          (default 1: deadline = period)
+ *      -j  execution times vary per job down to (1 - fraction) of the
+ *          drawn time (default 0: fixed)
+ *      -P  priority of the first task in deadline order (default 30, the
+ *          highest below the dispatcher in tman_sim); the others count
+ *          down to 1
+ *      -t  TMAN tick length in microseconds (default 1000, tman_sim -p 1)
+ *      -s  seed (default 1)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+/* Task names, one character each */
+static const char NAMES[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+/* As many tasks as tman_sim takes (TMAN_MAX_TASKS of Tools/sim/FreeRTOSConfig.h),
+ * no more than there are names */
+#ifndef MAX_TASKS
+#define MAX_TASKS 32
+#endif
+_Static_assert(MAX_TASKS <= (int)sizeof NAMES - 1, "more tasks than names");
+
+struct GEN_TASK {
+    double utilization;
+    int period;            // TMAN ticks
+    int deadline;          // TMAN ticks
+    unsigned long exec;    // microseconds
+    int priority;
+    char predecessors[MAX_TASKS + 1];
+};
+
+struct GEN_TASK TASKS[MAX_TASKS];
+
+/* UUniFast: n utilizations adding up to 'total', uniformly distributed */
+static void uunifast(int n, double total)
+{
+    double sum = total;
+
+    for (int i = 0; i < n - 1; i++){
+        double next = sum * pow(drand48(), 1.0 / (n - 1 - i));
+
+        TASKS[i].utilization = sum - next;
+        sum = next;
+    }
+    TASKS[n - 1].utilization = sum;
+}
+
+static int period_draw(int min, int max, char distribution)
+{
+    switch (distribution){
+        case 'u':
+            return min + (int)(drand48() * (max - min + 1));
+        case 'h': {
+            int steps = 0;
+
+            while ((long)min << (steps + 1) <= max){
+                steps++;
+            }
+            return min << (int)(drand48() * (steps + 1));
+        }
+        default: {
+            int period = (int)floor(exp(log(min) + drand48() * (log(max + 1.0) - log(min))));
+
+            return period > max ? max : period;
+        }
+    }
+}
+
+/* Deadline monotonic: rank the tasks by deadline, the shortest first */
+static void priorities_assign(int n, int highest)
+{
+    int order[MAX_TASKS];
+
+    for (int i = 0; i < n; i++){
+        order[i] = i;
+    }
+    for (int i = 1; i < n; i++){
+        int k = order[i];
+        int j = i;
+
+        while (j > 0 && TASKS[order[j - 1]].deadline > TASKS[k].deadline){
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = k;
+    }
+    for (int rank = 0; rank < n; rank++){
+        TASKS[order[rank]].priority = highest - rank * highest / n;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int n = 8;
+    double utilization = 0.5;
+    int period_min = 10, period_max = 1000;
+    char distribution = 'l';
+    double density = 0;
+    double deadline_fraction = 1;
+    double exec_variation = 0;
+    int highest = 30;
+    double tick_us = 1000;
+    long seed = 1;
+    double total = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:u:p:d:c:D:j:P:t:s:")) != -1){
+        switch (option){
+            case 'n':
+                n = atoi(optarg);
+                break;
+            case 'u':
+                utilization = atof(optarg);
+                break;
+            case 'p':
+                if (sscanf(optarg, "%d-%d", &period_min, &period_max) != 2){
+                    period_max = period_min;
+                }
+                break;
+            case 'd':
+                distribution = optarg[0];
+                break;
+            case 'c':
+                density = atof(optarg);
+                break;
+            case 'D':
+                deadline_fraction = atof(optarg);
+                break;
+            case 'j':
+                exec_variation = atof(optarg);
+                break;
+            case 'P':
+                highest = atoi(optarg);
+                break;
+            case 't':
+                tick_us = atof(optarg);
+                break;
+            case 's':
+                seed = atol(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n tasks] [-u utilization] [-p min-max] [-d u|l|h] [-c density] "
+                        "[-D fraction] [-j fraction] [-P priority] [-t tick_us] [-s seed]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (n <= 0 || n > MAX_TASKS || utilization <= 0 || period_min <= 0 || period_max < period_min ||
+            strchr("ulh", distribution) == NULL || density < 0 || density > 1 || deadline_fraction <= 0 ||
+            deadline_fraction > 1 || exec_variation < 0 || exec_variation >= 1 || highest <= 0 || tick_us <= 0){
+        fprintf(stderr, "tman_gen: bad parameters (1 to %d tasks)\n", MAX_TASKS);
+        return EXIT_FAILURE;
+    }
+
+    srand48(seed);
+    uunifast(n, utilization);
+
+    for (int i = 0; i < n; i++){
+        struct GEN_TASK *task = &TASKS[i];
+        int min_deadline;
+
+        task->period = period_draw(period_min, period_max, distribution);
+        task->exec = (unsigned long)(task->utilization * task->period * tick_us + 0.5);
+        if (task->exec == 0){
+            task->exec = 1;
+        }
+        total += task->exec / (task->period * tick_us);
+
+        /* Constrained deadline, not shorter than the execution time */
+        min_deadline = (int)ceil(deadline_fraction * task->period);
+        if (min_deadline < (int)ceil(task->exec / tick_us)){
+            min_deadline = (int)ceil(task->exec / tick_us);
+        }
+        if (min_deadline > task->period){
+            min_deadline = task->period;
+        }
+        task->deadline = min_deadline + (int)(drand48() * (task->period - min_deadline + 1));
+
+        /* Predecessors among the tasks generated before */
+        int k = 0;
+        for (int j = 0; j < i; j++){
+            if (drand48() < density){
+                task->predecessors[k++] = NAMES[j];
+            }
+        }
+        task->predecessors[k] = '\0';
+    }
+    priorities_assign(n, highest);
+
+    printf("# tman_gen -n %d -u %g -p %d-%d -d %c -c %g -D %g -j %g -P %d -t %g -s %ld\n", n, utilization,
+            period_min, period_max, distribution, density, deadline_fraction, exec_variation, highest, tick_us, seed);
+    printf("# utilization %.4f\n", total);
+    printf("#\n# name priority period phase deadline exec(us) [predecessors]\n");
+    for (int i = 0; i < n; i++){
+        struct GEN_TASK *task = &TASKS[i];
+        unsigned long min = (unsigned long)((1 - exec_variation) * task->exec);
+
+        printf("%c %d %d 0 %d ", NAMES[i], task->priority, task->period, task->deadline);
+        if (min < task->exec){
+            printf("%lu-%lu", min, task->exec);
+        }
+        else {
+            printf("%lu", task->exec);
+        }
+        printf(" %s\n", task->predecessors);
+    }
+
+    return EXIT_SUCCESS;
+}
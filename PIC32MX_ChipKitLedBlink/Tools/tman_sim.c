@@ -0,0 +1,761 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN schedule simulator (host tool)
+ * - Runs the TMAN dispatcher (../tman.c, built with TMAN_USE_SIMULATION)
+ *      on a simulated kernel (sim/) and simulated time: same releases,
+ *      precedence and deadline checks as on the board
+ * - Discrete events: the simulated time jumps from a TMAN tick or a job
+ *      completion to the next; the jobs of the tasks take the given
+ *      execution times, scheduled by fixed priority with preemption (equal
+ *      priorities share the processor, switched at every kernel tick)
+ * - Critical sections on TMAN shared resources, locked and unlocked through
+ *      TMAN_ResourceLock/Unlock() at given points of the execution of the
+ *      jobs (the priority ceilings then apply)
+ * - Prints the TMAN task statistics (activations, deadline misses,
+ *      response times, blocking) at the end, and the host time the
+ *      dispatcher took per TMAN tick
+ *
+ * Usage: tman_sim [-t ticks] [-p period] [-s seed] [-v] [-b] [file]
+ *      -t  TMAN ticks to simulate (default 1000)
+ *      -p  TMAN tick period in kernel ticks of 1 ms (default 1)
+ *      -s  seed of the execution time draws (default 1)
+ *      -v  print the TMAN log (one line per job, deadline misses)
+ *      -b  print one line of totals over all the tasks instead (for
+ *          tman_bench.sh):
+ *          BENCH tasks activations misses jobs dispatch_ns ratio_max h...
+ *          dispatch_ns: mean host time of the dispatcher per TMAN tick;
+ *          ratio_max: largest response / deadline (1/1000); h...: the
+ *          response / deadline histogram of TMAN_TaskStats(), late jobs
+ *          last
+ *
+ * Task file, one task per line, '#' starts a comment:
+ *
+ *      name priority period phase deadline exec [predecessors] [sections] [change]
+ *
+ *      period, phase and deadline in TMAN ticks; exec in microseconds, a
+ *      fixed time or a range "min-max" drawn from for every job;
+ *      predecessors is the list of the task names, e.g. "AB"; a section
+ *      "R:start:length" holds resource R from 'start' microseconds of
+ *      execution of the job for 'length' more (cut short when the job
+ *      ends first). Sections are listed by start, a section that starts
+ *      inside another one has to end inside it. A change "@tick:period"
+ *      gives the task a new period at TMAN tick 'tick' (taskModifyPeriod(),
+ *      from task level, with the jobs released at that tick still
+ *      pending).
+ *
+ * Exit status: 0, 2 if a deadline was missed, 1 on errors
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tman.h"
+
+#if TMAN_MAX_RESOURCES == 0
+#error "tman_sim needs the shared resources (TMAN_MAX_RESOURCES > 0)"
+#endif
+
+/* Critical sections per task */
+#define MAX_SECTIONS 8
+
+/* Kernel task of the simulated kernel */
+struct tskTaskControlBlock {
+    int used;              // slot holds a task
+    int id;                // TMAN task id (-1: not a TMAN task)
+    UBaseType_t priority;  // kernel priority
+    unsigned notifications; // jobs handed over and not started
+    int in_job;            // a job is started
+    uint64_t remaining;    // execution time left to the job (us)
+    uint64_t done;         // execution time of the job so far (us)
+    int section;           // next critical section of the job
+    int open[MAX_SECTIONS]; // sections entered and not left, innermost last
+    int n_open;
+    unsigned long order;   // rank among the ready tasks of its priority
+};
+
+#define MAX_KERNEL_TASKS (TMAN_MAX_TASKS + 2)
+
+struct tskTaskControlBlock KERNEL_TASKS[MAX_KERNEL_TASKS];
+TaskHandle_t CURRENT;      // running task, NULL when idle or dispatching
+unsigned long ready_order; // last rank given
+uint64_t now;              // simulated time (us)
+uint64_t busy;             // time the tasks ran (us)
+uint64_t dispatch_ns;      // host time spent in the dispatcher
+
+/* Part of the execution of a job holding a resource */
+struct SIM_SECTION {
+    char resource;
+    uint32_t start;        // execution time before the lock (us)
+    uint32_t length;       // execution time holding the resource (us)
+};
+
+/* Task set read from the task file, in TMAN id order */
+struct SIM_TASK {
+    char name;
+    int priority;
+    int period;
+    int phase;
+    int deadline;
+    uint32_t exec_min;     // execution time of a job (us)
+    uint32_t exec_max;
+    char predecessors[TMAN_MAX_TASKS + 1];
+    struct SIM_SECTION section[MAX_SECTIONS];
+    int sections;
+    int change_tick;       // TMAN tick of the period change (-1: none)
+    int change_period;     // period from then on
+};
+
+struct SIM_TASK SIM_TASKS[TMAN_MAX_TASKS];
+int n_tasks;
+
+TaskHandle_t HOLDERS[UCHAR_MAX + 1]; // task holding each resource, by name
+
+int suspended;             // vTaskSuspendAll() nesting
+int verbose;               // print the TMAN log
+uint64_t seed = 1;         // execution time draws
+
+/*
+ * Simulated kernel (sim/task.h)
+ */
+
+void vSimPrintf(const char *pcFormat, ...)
+{
+    va_list args;
+
+    if (!verbose){
+        return;
+    }
+    va_start(args, pcFormat);
+    vprintf(pcFormat, args);
+    va_end(args);
+}
+
+void vSimAssert(const char *pcFileName, unsigned long ulLine)
+{
+    fprintf(stderr, "tman_sim: assertion failed at %s:%lu\n", pcFileName, ulLine);
+    exit(EXIT_FAILURE);
+}
+
+uint32_t ulSimTimestamp(void)
+{
+    return (uint32_t)now;
+}
+
+static int task_ready(TaskHandle_t task)
+{
+    return task->used && task->id >= 0 && (task->in_job || task->notifications > 0);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char * const pcName, uint32_t usStackDepth,
+        void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask)
+{
+    for (int i = 0; i < MAX_KERNEL_TASKS; i++){
+        if (!KERNEL_TASKS[i].used){
+            memset(&KERNEL_TASKS[i], 0, sizeof KERNEL_TASKS[i]);
+            KERNEL_TASKS[i].used = 1;
+            KERNEL_TASKS[i].id = -1;
+            KERNEL_TASKS[i].priority = uxPriority;
+            *pxCreatedTask = &KERNEL_TASKS[i];
+            return pdPASS;
+        }
+    }
+    return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    TaskHandle_t task = xTaskToDelete != NULL ? xTaskToDelete : CURRENT;
+
+    if (task == CURRENT){
+        CURRENT = NULL;
+    }
+    /* An aborted job gives its resources back */
+    for (int r = 0; r <= UCHAR_MAX; r++){
+        if (HOLDERS[r] == task){
+            HOLDERS[r] = NULL;
+        }
+    }
+    task->used = 0;
+}
+
+void vTaskPrioritySet(TaskHandle_t xTask, UBaseType_t uxNewPriority)
+{
+    TaskHandle_t task = xTask != NULL ? xTask : CURRENT;
+
+    task->priority = uxNewPriority;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask)
+{
+    TaskHandle_t task = xTask != NULL ? xTask : CURRENT;
+
+    return task->priority;
+}
+
+void vTaskSetApplicationTaskTag(TaskHandle_t xTask, TaskHookFunction_t pxHookFunction)
+{
+    TaskHandle_t task = xTask != NULL ? xTask : CURRENT;
+
+    /* TMAN tags its tasks with id + 1 */
+    task->id = (int)(intptr_t)pxHookFunction - 1;
+}
+
+TaskHookFunction_t xTaskGetApplicationTaskTag(TaskHandle_t xTask)
+{
+    TaskHandle_t task = xTask != NULL ? xTask : CURRENT;
+
+    return (TaskHookFunction_t)(intptr_t)(task->id + 1);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return CURRENT;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    /* A woken task goes behind the ready tasks of its priority */
+    if (!task_ready(xTaskToNotify)){
+        xTaskToNotify->order = ++ready_order;
+    }
+    xTaskToNotify->notifications++;
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    xTaskNotifyGive(xTaskToNotify);
+    if (pxHigherPriorityTaskWoken != NULL){
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    /* Only the task functions block, and they are not run */
+    fprintf(stderr, "tman_sim: ulTaskNotifyTake() called\n");
+    exit(EXIT_FAILURE);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(now * configTICK_RATE_HZ / 1000000u);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+void vTaskSuspendAll(void)
+{
+    suspended++;
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    configASSERT(suspended > 0);
+    suspended--;
+    return pdFALSE;
+}
+
+void vTaskEndScheduler(void)
+{
+}
+
+/*
+ * Scheduler
+ */
+
+/* Highest priority ready task, the first in rank among equals */
+static TaskHandle_t ready_first(void)
+{
+    TaskHandle_t first = NULL;
+
+    for (int i = 0; i < MAX_KERNEL_TASKS; i++){
+        TaskHandle_t task = &KERNEL_TASKS[i];
+
+        if (task_ready(task) && (first == NULL || task->priority > first->priority ||
+                (task->priority == first->priority && task->order < first->order))){
+            first = task;
+        }
+    }
+    return first;
+}
+
+/* Another ready task has the priority of 'task' */
+static int ready_peer(TaskHandle_t task)
+{
+    for (int i = 0; i < MAX_KERNEL_TASKS; i++){
+        if (&KERNEL_TASKS[i] != task && task_ready(&KERNEL_TASKS[i]) && KERNEL_TASKS[i].priority == task->priority){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Context switch, through the TMAN switch hooks as in the kernel */
+static void switch_to(TaskHandle_t task)
+{
+    if (task == CURRENT){
+        return;
+    }
+    if (CURRENT != NULL){
+        TMAN_TraceSwitchedOut((void *)(intptr_t)(CURRENT->id + 1));
+    }
+    CURRENT = task;
+    if (task != NULL){
+        TMAN_TraceSwitchedIn((void *)(intptr_t)(task->id + 1));
+    }
+}
+
+/* Execution time of a job of task 'id' (us) */
+static uint64_t exec_draw(int id)
+{
+    uint32_t min = SIM_TASKS[id].exec_min;
+    uint32_t span = SIM_TASKS[id].exec_max - min;
+
+    if (span == 0){
+        return min;
+    }
+
+    /* xorshift64 */
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return min + seed % ((uint64_t)span + 1);
+}
+
+/* Execution time of the job of 'task' at its next lock or unlock
+ * (UINT64_MAX if none is left) */
+static uint64_t section_next(TaskHandle_t task)
+{
+    const struct SIM_TASK *sim = &SIM_TASKS[task->id];
+    uint64_t next = UINT64_MAX;
+
+    if (task->n_open > 0){
+        const struct SIM_SECTION *inner = &sim->section[task->open[task->n_open - 1]];
+
+        next = (uint64_t)inner->start + inner->length;
+    }
+    if (task->section < sim->sections && sim->section[task->section].start < next){
+        next = sim->section[task->section].start;
+    }
+    return next;
+}
+
+static void section_unlock(TaskHandle_t task)
+{
+    char resource = SIM_TASKS[task->id].section[task->open[--task->n_open]].resource;
+
+    HOLDERS[(unsigned char)resource] = NULL;
+    if (TMAN_ResourceUnlock(resource) != TMAN_SUCCESS){
+        fprintf(stderr, "tman_sim: task %c: unlock of %c failed\n", SIM_TASKS[task->id].name, resource);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* The lock or unlock due in the job of the running task. Returns 0 if
+ * the resource is held by another task, which may only happen between
+ * tasks of the same priority. */
+static int section_event(TaskHandle_t task)
+{
+    const struct SIM_TASK *sim = &SIM_TASKS[task->id];
+
+    if (task->n_open > 0){
+        const struct SIM_SECTION *inner = &sim->section[task->open[task->n_open - 1]];
+
+        if ((uint64_t)inner->start + inner->length <= task->done){
+            section_unlock(task);
+            return 1;
+        }
+    }
+
+    char resource = sim->section[task->section].resource;
+
+    if (HOLDERS[(unsigned char)resource] != NULL){
+        return 0;
+    }
+    if (TMAN_ResourceLock(resource) != TMAN_SUCCESS){
+        fprintf(stderr, "tman_sim: task %c: lock of %c failed\n", sim->name, resource);
+        exit(EXIT_FAILURE);
+    }
+    HOLDERS[(unsigned char)resource] = task;
+    task->open[task->n_open++] = task->section++;
+    return 1;
+}
+
+/* Run the tasks up to time 'until', then leave the processor to the
+ * dispatcher */
+static void run_until(uint64_t until)
+{
+    const uint64_t slice = 1000000u / configTICK_RATE_HZ;
+
+    while (now < until){
+        TaskHandle_t task = ready_first();
+        uint64_t stop = until;
+        uint64_t event, step;
+
+        if (task == NULL){
+            switch_to(NULL);
+            now = until;
+            break;
+        }
+        switch_to(task);
+        if (!task->in_job){
+            task->notifications--;
+            task->in_job = 1;
+            task->remaining = exec_draw(task->id);
+            task->done = 0;
+            task->section = 0;
+            task->n_open = 0;
+            TMAN_SimJobStart(task->id);
+        }
+
+        /* A lock or unlock due now changes the priorities; a resource
+         * held by a task of the same priority lets that one go on */
+        event = section_next(task);
+        if (event <= task->done){
+            if (!section_event(task)){
+                if (!ready_peer(task)){
+                    fprintf(stderr, "tman_sim: task %c waits for a resource held by a task it preempted\n",
+                            SIM_TASKS[task->id].name);
+                    exit(EXIT_FAILURE);
+                }
+                task->order = ++ready_order;
+            }
+            continue;
+        }
+        step = event - task->done < task->remaining ? event - task->done : task->remaining;
+
+#if configUSE_TIME_SLICING
+        if (ready_peer(task) && (now / slice + 1) * slice < stop){
+            stop = (now / slice + 1) * slice;
+        }
+#endif
+
+        if (step <= stop - now){
+            now += step;
+            busy += step;
+            task->done += step;
+            task->remaining -= step;
+            if (task->remaining == 0){
+                /* Sections cut short by the end of the job */
+                while (task->n_open > 0){
+                    section_unlock(task);
+                }
+                task->in_job = 0;
+                TMAN_SimJobEnd(task->id);
+            }
+            continue;
+        }
+
+        /* Preempted at a kernel tick: behind its equals */
+        task->remaining -= stop - now;
+        task->done += stop - now;
+        busy += stop - now;
+        now = stop;
+#if configUSE_TIME_SLICING
+        task->order = ++ready_order;
+#endif
+    }
+
+    /* The dispatcher takes the processor */
+    switch_to(NULL);
+}
+
+static uint64_t host_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+static void simulate(int ticks)
+{
+    const uint64_t tick = (uint64_t)TASK_TICK_PERIOD * 1000000u / configTICK_RATE_HZ;
+
+    while (TMAN_TICK < ticks){
+        for (int i = 0; i < n_tasks; i++){
+            if (SIM_TASKS[i].change_tick == TMAN_TICK &&
+                    taskModifyPeriod(SIM_TASKS[i].name, SIM_TASKS[i].change_period) != TMAN_SUCCESS){
+                fprintf(stderr, "tman_sim: task %c: period change not accepted\n", SIM_TASKS[i].name);
+                exit(EXIT_FAILURE);
+            }
+        }
+        run_until((uint64_t)(TMAN_TICK + 1) * tick);
+
+        /* A task left the kernel switches off (DISPATCHER_LOCK()) */
+        configASSERT(suspended == 0);
+        uint64_t start = host_ns();
+        TMAN_SimTick();
+        dispatch_ns += host_ns() - start;
+    }
+}
+
+/*
+ * Task file
+ */
+
+static int task_index(char name)
+{
+    for (int i = 0; i < n_tasks; i++){
+        if (SIM_TASKS[i].name == name){
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int read_tasks(FILE *in, const char *file)
+{
+    char line[256];
+    int line_no = 0;
+
+    while (fgets(line, sizeof line, in) != NULL){
+        struct SIM_TASK *task = &SIM_TASKS[n_tasks];
+        char name[2], exec[32];
+        unsigned long min, max;
+        int fields, used = 0;
+        uint64_t ends[MAX_SECTIONS]; // ends of the sections still open
+        int open = 0;
+
+        line_no++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        if (strspn(line, " \t") == strlen(line)){
+            continue;
+        }
+        if (n_tasks == TMAN_MAX_TASKS){
+            fprintf(stderr, "%s:%d: more than %d tasks\n", file, line_no, TMAN_MAX_TASKS);
+            return -1;
+        }
+
+        task->predecessors[0] = '\0';
+        task->sections = 0;
+        task->change_tick = -1;
+        fields = sscanf(line, "%1s %d %d %d %d %31s%n", name, &task->priority, &task->period, &task->phase,
+                &task->deadline, exec, &used);
+        if (fields < 6){
+            fprintf(stderr, "%s:%d: expected name priority period phase deadline exec [predecessors] [sections]\n",
+                    file, line_no);
+            return -1;
+        }
+        for (char *token = strtok(line + used, " \t"); token != NULL; token = strtok(NULL, " \t")){
+            struct SIM_SECTION *section = &task->section[task->sections];
+            char resource[2], rest;
+
+            if (token[0] == '@'){
+                if (task->change_tick >= 0 || sscanf(token, "@%d:%d%c", &task->change_tick, &task->change_period,
+                        &rest) != 2 || task->change_tick < 0){
+                    fprintf(stderr, "%s:%d: bad period change '%s' (at most one per task)\n", file, line_no, token);
+                    return -1;
+                }
+                continue;
+            }
+            if (strchr(token, ':') == NULL){
+                if (task->predecessors[0] != '\0' || strlen(token) > TMAN_MAX_TASKS){
+                    fprintf(stderr, "%s:%d: bad predecessors '%s'\n", file, line_no, token);
+                    return -1;
+                }
+                strcpy(task->predecessors, token);
+                continue;
+            }
+            if (task->sections == MAX_SECTIONS ||
+                    sscanf(token, "%1[^:]:%lu:%lu%c", resource, &min, &max, &rest) != 3 || max > UINT32_MAX){
+                fprintf(stderr, "%s:%d: bad critical section '%s' (at most %d per task)\n", file, line_no, token,
+                        MAX_SECTIONS);
+                return -1;
+            }
+            section->resource = resource[0];
+            section->start = min;
+            section->length = max;
+
+            /* Leave the sections that end before this one starts */
+            while (open > 0 && ends[open - 1] <= section->start){
+                open--;
+            }
+            if ((task->sections > 0 && section->start < task->section[task->sections - 1].start) ||
+                    (open > 0 && (uint64_t)section->start + section->length > ends[open - 1])){
+                fprintf(stderr, "%s:%d: critical section '%s' out of order or not nested\n", file, line_no, token);
+                return -1;
+            }
+            ends[open++] = (uint64_t)section->start + section->length;
+            task->sections++;
+        }
+        fields = sscanf(exec, "%lu-%lu", &min, &max);
+        if (fields == 1){
+            max = min;
+        }
+        if (fields < 1 || max < min || max > UINT32_MAX){
+            fprintf(stderr, "%s:%d: bad execution time '%s'\n", file, line_no, exec);
+            return -1;
+        }
+        task->name = name[0];
+        task->exec_min = min;
+        task->exec_max = max;
+        if (task_index(task->name) >= 0){
+            fprintf(stderr, "%s:%d: task %c defined twice\n", file, line_no, task->name);
+            return -1;
+        }
+        n_tasks++;
+    }
+    return 0;
+}
+
+/* Add the resources of the critical sections and declare the tasks that
+ * use them, with their longest section on each */
+static int register_resources(void)
+{
+    for (int i = 0; i < n_tasks; i++){
+        for (int s = 0; s < SIM_TASKS[i].sections; s++){
+            char resource = SIM_TASKS[i].section[s].resource;
+            uint32_t longest = 0;
+
+            for (int t = 0; t < SIM_TASKS[i].sections; t++){
+                if (SIM_TASKS[i].section[t].resource == resource && SIM_TASKS[i].section[t].length > longest){
+                    longest = SIM_TASKS[i].section[t].length;
+                }
+            }
+            TMAN_ResourceAdd(resource);
+            if (TMAN_ResourceUse(resource, SIM_TASKS[i].name, (int)longest) != TMAN_SUCCESS){
+                fprintf(stderr, "tman_sim: task %c: use of resource %c not accepted\n", SIM_TASKS[i].name, resource);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Add and register the tasks with TMAN */
+static int register_tasks(void)
+{
+    for (int i = 0; i < n_tasks; i++){
+        if (TMAN_TaskAdd(SIM_TASKS[i].name) != i){
+            fprintf(stderr, "tman_sim: task %c not added\n", SIM_TASKS[i].name);
+            return -1;
+        }
+    }
+    if (register_resources() != 0){
+        return -1;
+    }
+
+    for (int i = 0; i < n_tasks; i++){
+        struct SIM_TASK *task = &SIM_TASKS[i];
+        int precedences[TMAN_MAX_TASKS + 1];
+        int n = 0;
+
+        for (const char *p = task->predecessors; *p != '\0'; p++){
+            precedences[n] = task_index(*p);
+            if (precedences[n] < 0){
+                fprintf(stderr, "tman_sim: task %c: unknown predecessor %c\n", task->name, *p);
+                return -1;
+            }
+            n++;
+        }
+        precedences[n] = -1;
+
+        if (TMAN_TaskRegisterAttributes(task->name, task->priority, task->period, task->phase, task->deadline,
+                precedences) != TMAN_SUCCESS){
+            fprintf(stderr, "tman_sim: task %c not registered\n", task->name);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    const char *file = "stdin";
+    int ticks = 1000;
+    int period = 1;
+    int bench = 0;
+    int option;
+    struct TMAN_SIM_TOTALS totals;
+
+    while ((option = getopt(argc, argv, "t:p:s:vb")) != -1){
+        switch (option){
+            case 't':
+                ticks = atoi(optarg);
+                break;
+            case 'p':
+                period = atoi(optarg);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'v':
+                verbose = 1;
+                break;
+            case 'b':
+                bench = 1;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t ticks] [-p period] [-s seed] [-v] [-b] [file]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (ticks <= 0 || period <= 0){
+        fprintf(stderr, "tman_sim: ticks and period must be positive\n");
+        return EXIT_FAILURE;
+    }
+    if (seed == 0){
+        seed = 1;
+    }
+
+    if (optind < argc){
+        file = argv[optind];
+        in = fopen(file, "r");
+        if (in == NULL){
+            perror(file);
+            return EXIT_FAILURE;
+        }
+    }
+    if (read_tasks(in, file) != 0){
+        return EXIT_FAILURE;
+    }
+    if (n_tasks == 0){
+        fprintf(stderr, "tman_sim: no tasks\n");
+        return EXIT_FAILURE;
+    }
+
+    TMAN_Init(period, n_tasks);
+    if (register_tasks() != 0){
+        return EXIT_FAILURE;
+    }
+
+    uint64_t start = host_ns();
+    simulate(ticks);
+    double wall = (host_ns() - start) / 1e9;
+
+    TMAN_SimTotals(&totals);
+    if (bench){
+        printf("BENCH %d %u %u %u %.0f %u", n_tasks, totals.activations, totals.deadline_misses, totals.jobs,
+                (double)dispatch_ns / ticks, totals.response_ratio_max);
+        for (int b = 0; b <= TMAN_STATS_BUCKETS; b++){
+            printf(" %u", totals.histogram[b]);
+        }
+        printf("\n");
+    }
+    else {
+        verbose = 1;
+        TMAN_TaskStats();
+        printf("SIM: %d TMAN ticks, %.3f s simulated in %.3f s (%.0f ticks/s), CPU busy %.1f%%, dispatcher %.0f ns/tick\n",
+                ticks, now / 1e6, wall, wall > 0 ? ticks / wall : 0, now > 0 ? 100.0 * busy / now : 0,
+                (double)dispatch_ns / ticks);
+    }
+
+    return totals.deadline_misses > 0 ? 2 : EXIT_SUCCESS;
+}
@@ -0,0 +1,339 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN trace decoder (host tool)
+ * - Reads the byte stream written by TMAN with TMAN_USE_TRACE (UART capture
+ *      or the stdout of the Posix_GCC build); text between frames and
+ *      frames with a bad checksum are skipped
+ * - Prints the events and/or a Gantt chart of the jobs of every task
+ *
+ * Usage: tman_trace [-l] [-g] [-u units] [-w columns] [file]
+ *      -l  list the decoded events
+ *      -g  draw the Gantt chart (default when -l is not given)
+ *      -u  timestamp units per chart column (default: fit in -w columns)
+ *      -w  chart width in columns (default 100)
+ *
+ * Chart: '#' job running, '-' job released and waiting (or preempted),
+ *        '!' deadline miss, '+' budget overrun, 'x' job aborted
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tman_trace.h"
+
+#define MAX_TASKS 256
+
+/* Decoded record, time unwrapped to 64 bits */
+struct EVENT {
+   uint64_t time;
+   int event;
+   int task;
+};
+
+struct EVENT *EVENTS;     // decoded events
+int n_events;
+int events_size;
+
+char NAMES[MAX_TASKS];    // task names (0 if unknown)
+uint32_t clock_hz;        // timestamp units per second (0 if unknown)
+
+static const char *EVENT_NAMES[] = {
+    "CLOCK", "NAME", "RELEASE", "START", "END", "PREEMPT", "RESUME", "MISS",
+    "OVERRUN", "ABORT"
+};
+
+static void add_event(uint64_t time, int event, int task)
+{
+    if (n_events == events_size){
+        events_size = events_size ? 2 * events_size : 1024;
+        EVENTS = realloc(EVENTS, events_size * sizeof *EVENTS);
+        if (EVENTS == NULL){
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    EVENTS[n_events].time = time;
+    EVENTS[n_events].event = event;
+    EVENTS[n_events].task = task;
+    n_events++;
+}
+
+/* Find the frames in the stream and decode their records */
+static void decode(FILE *in)
+{
+    unsigned char *data = NULL;
+    size_t size = 0, capacity = 0, got;
+    uint64_t now = 0;
+    uint32_t last = 0;
+    int have_time = 0;
+    int bad = 0;
+
+    /* The whole capture is read first, so a false sync can be skipped
+     * without seeking (the input may be a pipe) */
+    do {
+        if (size == capacity){
+            capacity = capacity ? 2 * capacity : 65536;
+            data = realloc(data, capacity);
+            if (data == NULL){
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        got = fread(data + size, 1, capacity - size, in);
+        size += got;
+    } while (got > 0);
+
+    size_t pos = 0;
+    while (pos + 2 < size){
+        if (data[pos] != TMAN_TRACE_SYNC0 || data[pos + 1] != TMAN_TRACE_SYNC1){
+            pos++;
+            continue;
+        }
+
+        /* <n> <records> <checksum> */
+        unsigned char *frame = data + pos + 2;
+        int n = frame[0];
+        size_t len = 1 + n * TMAN_TRACE_RECORD_SIZE + 1;
+        unsigned char sum = 0;
+
+        if (n == 0 || n > TMAN_TRACE_FRAME_MAX || pos + 2 + len > size){
+            bad++;
+            pos++;
+            continue;
+        }
+        for (size_t i = 0; i < len; i++){
+            sum += frame[i];
+        }
+        if (sum != 0){
+            /* Not a frame after all, look for the next sync */
+            bad++;
+            pos++;
+            continue;
+        }
+        pos += 2 + len;
+
+        for (int i = 0; i < n; i++){
+            unsigned char *r = frame + 1 + i * TMAN_TRACE_RECORD_SIZE;
+            uint32_t time = r[0] | r[1] << 8 | r[2] << 16 | (uint32_t)r[3] << 24;
+            int event = r[4];
+            int task = r[5];
+
+            if (event == TMAN_TRACE_CLOCK){
+                clock_hz = time;
+                continue;
+            }
+            if (event == TMAN_TRACE_NAME){
+                NAMES[task] = time;
+                continue;
+            }
+
+            /* Timestamps wrap around at 32 bits */
+            if (have_time){
+                now += (uint32_t)(time - last);
+            }
+            else {
+                now = time;
+                have_time = 1;
+            }
+            last = time;
+            add_event(now, event, task);
+        }
+    }
+    free(data);
+
+    if (bad > 0){
+        fprintf(stderr, "tman_trace: %d bad frames skipped\n", bad);
+    }
+}
+
+static char task_name(int task)
+{
+    return NAMES[task] ? NAMES[task] : '?';
+}
+
+static void list(void)
+{
+    for (int i = 0; i < n_events; i++){
+        const char *name = EVENTS[i].event < (int)(sizeof EVENT_NAMES / sizeof *EVENT_NAMES) ? EVENT_NAMES[EVENTS[i].event] : "?";
+
+        printf("%12llu  %c  %s\n", (unsigned long long)EVENTS[i].time, task_name(EVENTS[i].task), name);
+    }
+}
+
+/* Paint columns [from, to] of a row; a column keeps the strongest mark */
+static int mark_rank(char c)
+{
+    return c == '!' ? 5 : c == 'x' ? 4 : c == '+' ? 3 : c == '#' ? 2 : c == '-' ? 1 : 0;
+}
+
+static void paint(char *row, long from, long to, char c)
+{
+    for (long col = from; col <= to; col++){
+        if (mark_rank(c) > mark_rank(row[col])){
+            row[col] = c;
+        }
+    }
+}
+
+static void gantt(uint64_t units, int width)
+{
+    int used[MAX_TASKS] = {0};
+    int pending[MAX_TASKS] = {0};
+    int running[MAX_TASKS] = {0};
+    uint64_t since[MAX_TASKS];
+    char *ROWS[MAX_TASKS] = {0};
+    uint64_t t0, t1;
+    long columns;
+
+    if (n_events == 0){
+        printf("no events\n");
+        return;
+    }
+    t0 = EVENTS[0].time;
+    t1 = EVENTS[n_events - 1].time;
+    if (units == 0){
+        units = (t1 - t0) / width + 1;
+    }
+    columns = (t1 - t0) / units + 1;
+    if (columns > width){
+        columns = width;
+        fprintf(stderr, "tman_trace: chart cut after %d columns\n", width);
+    }
+
+    for (int i = 0; i < n_events; i++){
+        used[EVENTS[i].task] = 1;
+    }
+    for (int t = 0; t < MAX_TASKS; t++){
+        if (used[t]){
+            ROWS[t] = malloc(columns + 1);
+            memset(ROWS[t], ' ', columns);
+            ROWS[t][columns] = '\0';
+        }
+    }
+
+    for (int i = 0; i < n_events; i++){
+        int t = EVENTS[i].task;
+        long col = (EVENTS[i].time - t0) / units;
+
+        if (col >= columns){
+            break;
+        }
+
+        /* Close the interval the task spent in its previous state */
+        if (running[t] || pending[t] > 0){
+            paint(ROWS[t], (since[t] - t0) / units, col, running[t] ? '#' : '-');
+        }
+        since[t] = EVENTS[i].time;
+
+        switch (EVENTS[i].event){
+            case TMAN_TRACE_RELEASE:
+                pending[t]++;
+                break;
+            case TMAN_TRACE_START:
+            case TMAN_TRACE_RESUME:
+                running[t] = 1;
+                break;
+            case TMAN_TRACE_PREEMPT:
+                running[t] = 0;
+                break;
+            case TMAN_TRACE_END:
+            case TMAN_TRACE_ABORT:
+                running[t] = 0;
+                if (pending[t] > 0){
+                    pending[t]--;
+                }
+                if (EVENTS[i].event == TMAN_TRACE_ABORT){
+                    paint(ROWS[t], col, col, 'x');
+                }
+                break;
+            case TMAN_TRACE_MISS:
+                paint(ROWS[t], col, col, '!');
+                break;
+            case TMAN_TRACE_OVERRUN:
+                paint(ROWS[t], col, col, '+');
+                break;
+        }
+    }
+
+    if (clock_hz != 0){
+        printf("1 column = %llu units = %.3f ms\n", (unsigned long long)units, 1000.0 * units / clock_hz);
+    }
+    else {
+        printf("1 column = %llu units\n", (unsigned long long)units);
+    }
+
+    /* Time axis: a tick every 10 columns */
+    printf("   ");
+    for (long col = 0; col < columns; col++){
+        putchar(col % 10 == 0 ? '|' : ' ');
+    }
+    putchar('\n');
+
+    for (int t = 0; t < MAX_TASKS; t++){
+        if (ROWS[t] != NULL){
+            printf("%c  %s\n", task_name(t), ROWS[t]);
+            free(ROWS[t]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    int do_list = 0;
+    int do_gantt = 0;
+    uint64_t units = 0;
+    int width = 100;
+    int option;
+
+    while ((option = getopt(argc, argv, "lgu:w:")) != -1){
+        switch (option){
+            case 'l':
+                do_list = 1;
+                break;
+            case 'g':
+                do_gantt = 1;
+                break;
+            case 'u':
+                units = strtoull(optarg, NULL, 0);
+                break;
+            case 'w':
+                width = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-l] [-g] [-u units] [-w columns] [file]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (width <= 0){
+        width = 100;
+    }
+    if (!do_list){
+        do_gantt = 1;
+    }
+
+    if (optind < argc){
+        in = fopen(argv[optind], "rb");
+        if (in == NULL){
+            perror(argv[optind]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    decode(in);
+
+    if (do_list){
+        list();
+    }
+    if (do_gantt){
+        gantt(units, width);
+    }
+
+    return EXIT_SUCCESS;
+}
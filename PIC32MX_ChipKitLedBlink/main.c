@@ -43,6 +43,8 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+/* TMAN includes */
+#include "tman.h"
 
 /* Hardware specific includes. */
 #include "ConfigPerformance.h"
@@ -73,6 +75,21 @@ static void prvSetupHardware( void );
  */
 extern void mainSetrLedBlink( void );
 
+#if TMAN_USE_HIRES_TIME
+/*
+ * TMAN alarm on the core timer compare interrupt. The kernel tick uses
+ * timer 1; the core timer counts the TMAN timestamps and its compare register
+ * is free. The handler is entered through the assembly wrapper in
+ * tman_alarm_isr.S, which saves the task context as the kernel needs. The
+ * IPL of the vector is the priority prvSetupTmanAlarm() gives the interrupt.
+ */
+#if configMAX_SYSCALL_INTERRUPT_PRIORITY != 3
+#error "The TMAN alarm vector is declared IPL3AUTO, change it with configMAX_SYSCALL_INTERRUPT_PRIORITY"
+#endif
+static void prvSetupTmanAlarm( void );
+void __attribute__( (interrupt(IPL3AUTO), vector(_CORE_TIMER_VECTOR))) vTmanAlarmWrapper( void );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -100,7 +117,9 @@ static void prvSetupHardware( void )
 
 	portDISABLE_INTERRUPTS();
 
-	
+#if TMAN_USE_HIRES_TIME
+	prvSetupTmanAlarm();
+#endif
 }
 /*-----------------------------------------------------------*/
 
@@ -156,9 +175,75 @@ void vApplicationTickHook( void )
 	added here, but the tick hook is called from an interrupt context, so
 	code must not attempt to block, and only the interrupt safe FreeRTOS API
 	functions can be used (those that end in FromISR()). */
+
+	/* TMAN execution time budgets, or the TMAN dispatcher */
+	TMAN_TickHook();
+}
+/*-----------------------------------------------------------*/
+
+#if TMAN_USE_HIRES_TIME
+
+static void prvSetupTmanAlarm( void )
+{
+	/* No match for a full turn of the counter until TMAN arms the alarm.
+	The priority must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+	_CP0_SET_COMPARE( _CP0_GET_COUNT() - 1 );
+	IFS0CLR = _IFS0_CTIF_MASK;
+	IPC0CLR = _IPC0_CTIP_MASK | _IPC0_CTIS_MASK;
+	IPC0SET = ( configMAX_SYSCALL_INTERRUPT_PRIORITY << _IPC0_CTIP_POSITION );
+	IEC0SET = _IEC0_CTIE_MASK;
+}
+/*-----------------------------------------------------------*/
+
+void vTmanAlarmSet( uint32_t ulStamp )
+{
+	/* Called by the TMAN dispatcher only, so no other task moves the compare
+	register. Writing it also clears a match still pending in the core. */
+	_CP0_SET_COMPARE( ulStamp );
+}
+/*-----------------------------------------------------------*/
+
+void vTmanAlarmHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	IFS0CLR = _IFS0_CTIF_MASK;
+	TMAN_AlarmFromISR( &xHigherPriorityTaskWoken );
+	portEND_SWITCHING_ISR( xHigherPriorityTaskWoken );
 }
 /*-----------------------------------------------------------*/
 
+#endif /* TMAN_USE_HIRES_TIME */
+
+#if configSUPPORT_STATIC_ALLOCATION == 1
+
+void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize )
+{
+static StaticTask_t xIdleTaskTCB;
+static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+	/* With configSUPPORT_STATIC_ALLOCATION the kernel takes the memory of
+	the idle task from here instead of the heap. */
+	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+	*ppxIdleTaskStackBuffer = uxIdleTaskStack;
+	*pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+{
+static StaticTask_t xTimerTaskTCB;
+static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+	/* Same for the timer service task. */
+	*ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+	*ppxTimerTaskStackBuffer = uxTimerTaskStack;
+	*pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
 void _general_exception_handler( unsigned long ulCause, unsigned long ulStatus )
 {
 	/* This overrides the definition provided by the kernel.  Other exceptions 
@@ -0,0 +1,3677 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN - Task Manager framework for FreeRTOS
+ * - Periodic tasks with period, phase and deadline expressed in TMAN ticks
+ * - Sporadic tasks activated from tasks or ISRs, with a minimum
+ *      inter-arrival time
+ * - Precedence constraints between tasks (any acyclic graph)
+ * - Calendar or time-triggered (hyperperiod table) dispatching, by a
+ *      dispatcher task or in the kernel tick hook
+ * - TMAN ticks of a number of kernel ticks, or of microseconds with the
+ *      dispatcher woken by a timer compare interrupt
+ * - Operating modes (named task sets) switched at an idle instant or a
+ *      hyperperiod boundary
+ * - Fixed priorities or EDF (priorities set at release from deadlines)
+ * - Deadline monotonic priorities and admission control by response time
+ *      analysis
+ * - Aperiodic servers (polling, deferrable) for jobs submitted by tasks and
+ *      ISRs
+ * - Shared resources with ceilings derived from the tasks that use them:
+ *      immediate priority ceiling locking, or the Stack Resource Policy
+ *      with EDF; blocking bounded in the admission control and measured
+ * - Execution time budgets, overruns counted, demoted or suspended
+ * - Deadline miss detection and activation statistics; late jobs continue,
+ *      are aborted, or make the next release be skipped; (m,k)-firm
+ *      constraints checked
+ * - Per-job response time, start latency, execution time and release
+ *      jitter, measured with a high resolution timestamp
+ * - CPU utilization per task from the kernel run time stats, against the
+ *      declared utilization
+ * - Static task memory (no heap), stack depth chosen per task
+ * - Task set given as a constant table checked at build time, registered
+ *      in one pass
+ * - Optional binary event trace (tman_trace.h)
+ * - Host schedule simulator build: the same dispatcher on simulated time
+ *      (Tools/tman_sim.c)
+ *
+ * Only the FreeRTOS kernel API is used here; all board specific code
+ * (UART, leds) stays in the application.
+ *
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* TMAN includes */
+#include "tman.h"
+#include "tman_trace.h"
+
+int TASK_TICK_PERIOD; // TICK TASK PERIOD
+int TMAN_TICK;        // TMAN TICK COUNTER
+int TMAN_N_TASKS;     // NUMBER OF TMAN TASKS
+TaskHandle_t TICK_HANDLER; // TASK TICK HANDLER
+
+/* Priorities of the demo application tasks (high numb. -> high prio.) */
+#define TASK_TICK_PRIORITY ( configMAX_PRIORITIES - 1 )
+
+/* Unit of the TMAN tick period: kernel ticks, or microseconds with the
+ * high resolution time base */
+#if TMAN_USE_HIRES_TIME
+#define TICK_PERIOD_HZ 1000000u
+#ifndef TMAN_ALARM_SET
+#error "TMAN_USE_HIRES_TIME needs TMAN_ALARM_SET() in FreeRTOSConfig.h"
+#endif
+#else
+#define TICK_PERIOD_HZ configTICK_RATE_HZ
+#endif
+
+#if TMAN_USE_ISR_DISPATCHER
+
+#if TMAN_USE_TICKLESS || TMAN_USE_BUDGET || TMAN_USE_EDF || !TMAN_USE_DEFERRED_LOG
+#error "TMAN_USE_ISR_DISPATCHER does not go with TMAN_USE_TICKLESS, TMAN_USE_BUDGET, TMAN_USE_EDF or without TMAN_USE_DEFERRED_LOG"
+#endif
+/* A mode change builds the time-triggered table again, too long a job for
+ * the tick interrupt */
+#if TMAN_USE_TIME_TRIGGERED && TMAN_MAX_MODES > 0
+#error "TMAN_USE_ISR_DISPATCHER does not go with TMAN_USE_TIME_TRIGGERED and modes (TMAN_MAX_MODES > 0)"
+#endif
+
+TickType_t dispatcher_last;     // kernel tick of the last TMAN tick dispatched
+volatile int dispatcher_locked; // tasks changing the calendar (dispatch held back)
+
+/* Critical sections on the dispatcher path, which runs in the tick
+ * interrupt: the interrupt safe kind */
+#define DISPATCHER_ENTER_CRITICAL() UBaseType_t critical_state = taskENTER_CRITICAL_FROM_ISR()
+#define DISPATCHER_EXIT_CRITICAL()  taskEXIT_CRITICAL_FROM_ISR(critical_state)
+#define DISPATCHER_LOCK()           dispatcher_lock()
+#define DISPATCHER_UNLOCK()         dispatcher_unlock()
+
+#else
+
+#define DISPATCHER_ENTER_CRITICAL() taskENTER_CRITICAL()
+#define DISPATCHER_EXIT_CRITICAL()  taskEXIT_CRITICAL()
+/* Tasks changing the calendar: the dispatcher task runs above them and
+ * must not find the heap half sifted, so the kernel does not switch tasks
+ * until the change is complete */
+#define DISPATCHER_LOCK()           vTaskSuspendAll()
+#define DISPATCHER_UNLOCK()         (void)xTaskResumeAll()
+
+#endif /* TMAN_USE_ISR_DISPATCHER */
+
+#if TMAN_USE_SIMULATION && (TMAN_USE_TICKLESS || TMAN_USE_ISR_DISPATCHER || TMAN_USE_BUDGET || TMAN_USE_DEFERRED_LOG || TMAN_MAX_SERVERS > 0)
+#error "TMAN_USE_SIMULATION does not go with TMAN_USE_TICKLESS, TMAN_USE_ISR_DISPATCHER, TMAN_USE_BUDGET, TMAN_USE_DEFERRED_LOG or servers"
+#endif
+
+#if TMAN_USE_STATIC_ALLOCATION
+
+#if configSUPPORT_STATIC_ALLOCATION != 1
+#error "TMAN_USE_STATIC_ALLOCATION needs configSUPPORT_STATIC_ALLOCATION"
+#endif
+
+/* Memory of the TMAN kernel tasks, reserved at build time (the TCBs of the
+ * TMAN tasks are in their TASK entry) */
+#if !TMAN_USE_ISR_DISPATCHER && !TMAN_USE_SIMULATION
+StaticTask_t TICK_TCB;    // dispatcher
+StackType_t TICK_STACK[TMAN_TICK_STACK_SIZE];
+#endif
+#if TMAN_USE_DEFERRED_LOG
+StaticTask_t LOG_TCB;     // logger
+StackType_t LOG_STACK[TMAN_LOG_STACK_SIZE];
+#endif
+StackType_t STACK_POOL[TMAN_STACK_POOL]; // stacks of the TMAN tasks
+int stack_pool_used;      // words handed out
+
+#endif /* TMAN_USE_STATIC_ALLOCATION */
+
+/* CPU utilization from the kernel run time counters */
+#if configGENERATE_RUN_TIME_STATS == 1 && configUSE_TRACE_FACILITY == 1
+#define TMAN_RUN_TIME_STATS 1
+#else
+#define TMAN_RUN_TIME_STATS 0
+#endif
+
+/* Job statistics, in TMAN_TIMESTAMP() units */
+struct JOB_STATS {
+   unsigned jobs;             // completed jobs measured
+   uint32_t response_min;     // release -> completion
+   uint32_t response_max;
+   uint64_t response_sum;
+   uint32_t latency_min;      // release -> start of execution
+   uint32_t latency_max;
+   uint64_t latency_sum;
+   uint32_t exec_min;         // time actually running
+   uint32_t exec_max;
+   uint64_t exec_sum;
+   uint32_t jitter_max;       // largest release interval error vs period
+#if TMAN_MAX_RESOURCES > 0
+   uint32_t blocking_min;     // release -> start, behind a resource ceiling
+   uint32_t blocking_max;
+   uint64_t blocking_sum;
+#endif
+   unsigned histogram[TMAN_STATS_BUCKETS + 1]; // response / deadline
+};
+
+/* Set of task ids, one bit per task */
+#if TMAN_MAX_TASKS <= 32
+typedef uint32_t task_mask_t;
+#elif TMAN_MAX_TASKS <= 64
+typedef uint64_t task_mask_t;
+#else
+#error "TMAN_MAX_TASKS is limited to 64 (task masks)"
+#endif
+#define TASK_BIT(id) ((task_mask_t)1 << (id))
+
+/* Task attributes checked by the admission control */
+struct ATTRIBUTES {
+   int period;
+   int phase;
+   int deadline;
+   int priority;
+   int wcet_us;
+   task_mask_t predecessors;
+};
+
+#if TMAN_MAX_SERVERS > 0
+
+/* Aperiodic job queued on a server */
+struct SERVER_REQUEST {
+   void (*job)(void *);   // job function
+   void *arg;             // its argument
+   uint32_t arrival;      // timestamp of the submission
+};
+
+/* Aperiodic server, times in TMAN_TIMESTAMP() units */
+struct SERVER {
+   int type;              // TMAN_SERVER_* type
+   uint32_t budget;       // budget per period
+   uint32_t remaining;    // budget left in the current period
+   QueueHandle_t queue;   // submitted jobs
+#if TMAN_USE_STATIC_ALLOCATION
+   StaticQueue_t queue_buffer; // its memory
+   uint8_t queue_storage[TMAN_SERVER_QUEUE_SIZE * sizeof(struct SERVER_REQUEST)];
+#endif
+   volatile unsigned dropped; // submissions lost, queue full
+   unsigned jobs;         // aperiodic jobs served
+   uint32_t response_min; // submission -> completion
+   uint32_t response_max;
+   uint64_t response_sum;
+};
+
+struct SERVER SERVERS[TMAN_MAX_SERVERS]; // servers array
+int server_count;         // servers in use
+
+#endif /* TMAN_MAX_SERVERS > 0 */
+
+#if TMAN_MAX_MODES > 0
+
+/* Attributes of a task in a mode */
+struct MODE_TASK {
+   int priority;
+   int period;
+   int phase;
+   int deadline;
+};
+
+/* Operating mode: the tasks that run in it and their attributes */
+struct MODE {
+   char name;             // mode name
+   task_mask_t tasks;     // tasks run in this mode
+   struct MODE_TASK task[TMAN_MAX_TASKS]; // their attributes, by task id
+};
+
+struct MODE MODES[TMAN_MAX_MODES]; // modes array
+int mode_count;           // modes in use
+int mode_current;         // mode in force (-1: tasks registered one by one)
+volatile int mode_requested; // mode to switch to at the next safe point (-1: none)
+int mode_safe_point;      // TMAN_MODE_* safe point of the request
+int mode_boundary;        // hyperperiod boundary (TMAN tick) awaited, 0: any idle instant
+int mode_request_tick;    // TMAN tick of the request
+int mode_changes;         // mode changes done
+int mode_delay_max;       // longest request -> change delay (TMAN ticks)
+
+#endif /* TMAN_MAX_MODES > 0 */
+
+#if TMAN_MAX_RESOURCES > 0
+
+/* Shared resource. Ceilings and levels are priorities, or in EDF mode
+ * preemption levels (minus the relative deadline, so a shorter deadline
+ * is a higher level). */
+struct RESOURCE {
+   char name;             // resource name
+   task_mask_t users;     // tasks that lock it
+   int cs_us[TMAN_MAX_TASKS]; // longest critical section of each user (us)
+   int ceiling;           // highest level of the registered users (INT_MIN: none)
+   int holder;            // task holding it (-1: free)
+   uint32_t locked;       // timestamp of the lock
+   unsigned locks;        // times locked
+   uint32_t held_max;     // longest time held (preemptions included)
+};
+
+struct RESOURCE RESOURCES[TMAN_MAX_RESOURCES]; // resources array
+int resource_count;       // resources in use
+
+#endif /* TMAN_MAX_RESOURCES > 0 */
+
+/* Task Structure */
+struct TASK {
+   int period;            // task period
+   char name;             // task name
+   int priority;          // task priority
+   int active_priority;   // priority currently set in the kernel
+   int wcet_us;           // declared worst-case execution time (0 if none)
+   volatile int activations; // number of activations (released jobs)
+   int phase;             // task phase
+   int deadline;          // task deadline
+   int deadline_misses;   // number of deadline misses
+   int miss_policy;       // TMAN_MISS_* policy
+   int skip_next;         // next release skipped (TMAN_MISS_SKIP)
+   int aborted;           // jobs aborted (TMAN_MISS_ABORT, TMAN_MISS_RESTART)
+   int skipped;           // releases skipped
+   int firm_m;            // (m,k)-firm constraint, k = 0 for none
+   int firm_k;
+   uint32_t firm_history; // last k deadlines, bit set if met (newest in bit 0)
+   int firm_outcomes;     // deadlines in the history, up to k
+   int firm_violations;   // windows of k deadlines with fewer than m met
+   int dispatched;        // jobs handed to the task (notifications given)
+   task_mask_t predecessors; // tasks that must have no pending jobs
+   TaskHandle_t handler;  // task Handler
+   TaskFunction_t work;   // task function (the task is re-created on it)
+   StackType_t *stack;    // static stack, NULL with dynamic allocation
+   int stack_size;        // stack depth (words)
+#if TMAN_USE_STATIC_ALLOCATION
+   StaticTask_t tcb;      // kernel task control block
+#endif
+   int next_release;      // absolute TMAN tick of the next release
+   int next_deadline;     // absolute TMAN tick of the pending deadline check
+   int calendar_pos;      // position in the release calendar (-1 if out)
+   int dispatching;       // task is in the dispatch list
+   volatile int in_job;   // job started and not completed
+   uint32_t release_stamp[TMAN_STATS_BACKLOG]; // timestamps of the last releases
+#if TMAN_USE_EDF
+   int release_tick[TMAN_STATS_BACKLOG]; // TMAN ticks of the last releases
+#endif
+   int jitter_valid;      // previous release is one period back
+   volatile int jobs_done; // completed jobs
+   uint32_t job_start;    // timestamp of the job start
+   uint32_t switched_in;  // timestamp of the last switch in
+   uint32_t exec;         // execution time of the running job
+   struct JOB_STATS stats; // job statistics
+   int sporadic;          // released on activation, period is the minimum inter-arrival time
+   volatile unsigned arrivals; // activations requested (tasks and ISRs)
+   unsigned arrivals_seen; // activations taken by the dispatcher
+   uint32_t arrival_stamp[TMAN_STATS_BACKLOG]; // timestamps of the last activations
+   int last_release;      // TMAN tick of the last sporadic release
+   int interarrival_violations; // activations before the minimum inter-arrival time
+#if TMAN_RUN_TIME_STATS
+   uint32_t run_time;     // kernel run time counter at the last stats
+#endif
+#if TMAN_USE_BUDGET
+   uint32_t budget;       // WCET in timestamp units (0: not enforced)
+   uint32_t budget_limit; // execution time allowed to the running job
+   volatile int overrun;  // the running job overran its budget
+   int overruns;          // number of budget overruns
+   int demoted;           // running at TMAN_OVERRUN_PRIORITY
+   int suspended;         // suspended until the next release
+#endif
+#if TMAN_MAX_SERVERS > 0
+   struct SERVER *server; // aperiodic server state (NULL for a plain task)
+#endif
+#if TMAN_MAX_RESOURCES > 0
+   int held[TMAN_MAX_RESOURCES]; // resources held, in lock order
+   int locks;             // resources held
+   uint32_t blocked;      // blocking of the next job to start so far
+#endif
+};
+
+struct TASK TASKS[TMAN_MAX_TASKS]; // Tasks array
+int task_id;              // id for initialization
+
+/* Direct-indexed lookup from task name to task id (-1 if unused) */
+short TASK_INDEX[UCHAR_MAX + 1];
+
+/* No deadline check pending */
+#define TMAN_NO_EVENT INT_MAX
+
+/* TMAN tick the periodic releases are aligned to (phases count from it):
+ * 0, or the tick the mode in force came into force */
+int release_origin;
+
+/*
+ * Release calendar: binary min-heap of task ids keyed on the next event
+ * (release or deadline check) of each task. Each TMAN tick only pops the
+ * tasks that have something due, so the tick cost grows with the number of
+ * released tasks and no period division is done in the dispatcher.
+ */
+int CALENDAR[TMAN_MAX_TASKS]; // heap of task ids
+int calendar_size;        // tasks in the calendar
+
+/* Tasks with released jobs not yet handed to them (held by precedence) */
+int DISPATCH[TMAN_MAX_TASKS]; // dispatch list of task ids
+int dispatch_size;        // tasks in the dispatch list
+int precedence_waiting;   // released tasks held back by precedence
+
+/* Tasks with released jobs not completed yet: set by the dispatcher at a
+ * release, cleared by the task when its backlog empties */
+volatile task_mask_t PENDING;
+
+/* Sporadic tasks */
+task_mask_t SPORADIC;
+
+#if TMAN_USE_BUDGET
+/* Overruns flagged by the tick and switch hooks, not yet handled by the
+ * dispatcher */
+volatile task_mask_t OVERRUN;
+volatile int RUNNING;      // id of the running TMAN task, -1 for others
+#endif
+
+#if TMAN_USE_TIME_TRIGGERED
+
+/*
+ * Time-triggered table: one slot per tick of the hyperperiod that has
+ * events, in tick order. The dispatcher keeps a cursor in the table and
+ * wraps around at the end of every hyperperiod.
+ */
+struct TT_SLOT {
+   int tick;                 // tick in the hyperperiod
+   task_mask_t deadlines;    // deadline checks due
+   task_mask_t releases;     // jobs released
+};
+
+struct TT_SLOT TT_TABLE[TMAN_TT_TABLE_SIZE];
+int tt_slots;             // slots in use (0: no table, calendar used)
+int tt_hyperperiod;       // hyperperiod (TMAN ticks)
+int tt_next;              // next slot
+int tt_base;              // TMAN tick where the current hyperperiod started
+
+#endif /* TMAN_USE_TIME_TRIGGERED */
+
+/* Log record types */
+#define LOG_JOB            0   // job done: "<name>, <tick>"
+#define LOG_DEADLINE_MISS  1   // deadline miss of task <name>
+#define LOG_OVERRUN        3   // budget overrun of task <name>
+#define LOG_MODE           4   // mode <name> in force from <tick>
+#define LOG_FIRM           5   // (m,k)-firm violation of task <name>
+#define LOG_TT_OVERFLOW    6   // time-triggered table too small, calendar used
+
+/* Ring used by the dispatcher, the tasks use the one at their id */
+#define LOG_DISPATCHER TMAN_MAX_TASKS
+
+#if TMAN_USE_DEFERRED_LOG
+
+#if (TMAN_LOG_SIZE & (TMAN_LOG_SIZE - 1)) != 0
+#error "TMAN_LOG_SIZE must be a power of two"
+#endif
+
+/*
+ * Deferred logging: every TMAN task and the dispatcher own a
+ * single-producer/single-consumer ring of log records. Writing a record
+ * never blocks (records that do not fit are only counted) and the rings are
+ * printed by a low priority logger task, so the UART stays out of the
+ * response time of the jobs and of the dispatcher.
+ */
+struct LOG_RECORD {
+   char type;             // record type
+   char name;             // task name
+   int tick;              // TMAN tick of the event
+};
+
+struct LOG_RING {
+   struct LOG_RECORD record[TMAN_LOG_SIZE]; // record slots
+   volatile unsigned head;    // records written (producer only)
+   volatile unsigned tail;    // records printed (logger only)
+   volatile unsigned dropped; // records lost, ring full (producer only)
+   unsigned dropped_reported; // drops already reported (logger only)
+};
+
+struct LOG_RING LOG[TMAN_MAX_TASKS + 1]; // one ring per task + dispatcher
+TaskHandle_t LOG_HANDLER;  // logger task handler
+volatile int stats_due;    // TMAN_TaskStats() asked of the logger
+
+/* Keep the compiler from moving record accesses across head/tail updates */
+#define LOG_BARRIER() __asm volatile( "" ::: "memory" )
+
+#endif /* TMAN_USE_DEFERRED_LOG */
+
+#if TMAN_USE_TRACE
+
+#if !TMAN_USE_DEFERRED_LOG
+#error "TMAN_USE_TRACE needs TMAN_USE_DEFERRED_LOG (the logger task streams the trace)"
+#endif
+#if (TMAN_TRACE_SIZE & (TMAN_TRACE_SIZE - 1)) != 0
+#error "TMAN_TRACE_SIZE must be a power of two"
+#endif
+
+/*
+ * Event trace: fixed size records written by the dispatcher, the tasks and
+ * the kernel task switch hooks. The writers are serialized by a short
+ * critical section (the switch hooks already run inside one), the logger
+ * task is the only reader and sends the records out in frames.
+ */
+struct TRACE_RECORD {
+   uint32_t time;         // timestamp (kernel ticks)
+   uint8_t event;         // TMAN_TRACE_* event
+   uint8_t task;          // task id
+};
+
+struct TRACE_RECORD TRACE[TMAN_TRACE_SIZE]; // trace buffer
+volatile unsigned trace_head;    // records written
+volatile unsigned trace_tail;    // records sent (logger only)
+volatile unsigned trace_dropped; // records lost, buffer full
+unsigned trace_dropped_reported; // drops already reported (logger only)
+
+/* Timestamp unit, sent in the TMAN_TRACE_CLOCK record */
+#define TRACE_TIME() TMAN_TIMESTAMP()
+#define TRACE_CLOCK_HZ ((uint32_t)TMAN_TIMESTAMP_HZ)
+
+#define TRACE(event, task) trace_put(event, task)
+
+#else
+
+#define TRACE(event, task)
+
+#endif /* TMAN_USE_TRACE */
+
+/*
+ * Prototypes
+ */
+void task_work(void *pvParam);
+void task_tick_work(void *pvParam);
+void task_manager(void);
+#if TMAN_USE_DEFERRED_LOG
+void task_log_work(void *pvParam);
+#endif
+static TaskHandle_t kernel_task_create(TaskFunction_t work, const char *name, int stack_size, void *param,
+        UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb);
+#if TMAN_MAX_SERVERS > 0
+void server_work(void *pvParam);
+#endif
+static void tman_log(int ring, char type, char name, int tick);
+static int task_lookup(char name);
+static int attributes_valid(int priority, int period, int phase, int deadline);
+static int attributes_admit(int j, const struct ATTRIBUTES *saved);
+static unsigned long stamp_to_us(uint64_t stamp);
+static void stats_add(uint32_t *min, uint32_t *max, uint64_t *sum, uint32_t value, unsigned jobs);
+#if TMAN_MAX_SERVERS > 0 || TMAN_USE_BUDGET
+static uint32_t us_to_stamp(unsigned long us);
+#endif
+static int task_backlog(int id);
+static task_mask_t precedence_closure(task_mask_t start);
+static int next_release_after(struct TASK *task, int tick);
+static void job_start(struct TASK *task);
+static void job_end(struct TASK *task);
+static uint32_t ticks_to_stamp(int tman_ticks);
+static int calendar_key(int id);
+static void calendar_swap(int a, int b);
+static void calendar_sift_up(int pos);
+static void calendar_sift_down(int pos);
+static void calendar_place(int id);
+static void calendar_changed(void);
+static void calendar_update(int id);
+#if TMAN_USE_TICKLESS
+static void dispatcher_wake(void);
+#endif
+#if TMAN_USE_ISR_DISPATCHER
+static void dispatcher_lock(void);
+static void dispatcher_unlock(void);
+static void tick_dispatch(void);
+#endif
+#if TMAN_USE_EDF
+static void edf_assign_priorities(void);
+#endif
+#if TMAN_USE_TIME_TRIGGERED
+static void tt_build(void);
+static int tt_dispatch(void);
+static void deadline_check(int task);
+#endif
+static void job_release(int task, uint32_t now);
+static int task_spawn(int id);
+#if TMAN_MAX_RESOURCES > 0
+static void resources_update(void);
+#if TMAN_USE_EDF
+static int resource_system_ceiling(void);
+#endif
+static void resource_release(int id);
+#endif
+#if TMAN_USE_TRACE
+static void trace_put(int event, int task);
+static void trace_info(int event, int task, uint32_t value);
+#endif
+
+void TMAN_Init(int TMAN_TICK_PERIOD_VALUE, int N_TASKS)
+{
+
+    /* Welcome message*/
+    TMAN_PRINTF("**********************************************\n\r");
+    TMAN_PRINTF("  TMAN - Task Manager framework for FreeRTOS  \n\r");
+    TMAN_PRINTF("**********************************************\n\r");
+
+    /* ID para Inicialização */
+    task_id = 0;
+#if TMAN_USE_STATIC_ALLOCATION
+    stack_pool_used = 0;
+#endif
+
+    /* Inicialização do Tick */
+    TMAN_TICK = 0;
+    TASK_TICK_PERIOD = TMAN_TICK_PERIOD_VALUE;
+
+    /* NUMBER OF TASKS TO MANAGE */
+    TMAN_N_TASKS = N_TASKS;
+    if (TMAN_N_TASKS > TMAN_MAX_TASKS){
+        TMAN_PRINTF("TMAN: only %d tasks supported (TMAN_MAX_TASKS)\n\r", TMAN_MAX_TASKS);
+        TMAN_N_TASKS = TMAN_MAX_TASKS;
+    }
+
+#if TMAN_USE_EDF
+    /* The EDF band must stay below the dispatcher */
+    configASSERT(TMAN_PRIORITY_MIN <= TMAN_PRIORITY_MAX && TMAN_PRIORITY_MAX < TASK_TICK_PRIORITY);
+#endif
+
+    /* Empty release calendar and dispatch list */
+    calendar_size = 0;
+#if TMAN_USE_TIME_TRIGGERED
+    tt_slots = 0;
+#endif
+    dispatch_size = 0;
+    precedence_waiting = 0;
+    PENDING = 0;
+    SPORADIC = 0;
+    release_origin = 0;
+#if TMAN_USE_BUDGET
+    OVERRUN = 0;
+    RUNNING = -1;
+#endif
+#if TMAN_MAX_SERVERS > 0
+    server_count = 0;
+#endif
+#if TMAN_MAX_MODES > 0
+    mode_count = 0;
+    mode_current = -1;
+    mode_requested = -1;
+    mode_changes = 0;
+    mode_delay_max = 0;
+#endif
+#if TMAN_MAX_RESOURCES > 0
+    resource_count = 0;
+#endif
+
+    /* Inicialização da tabela de Tasks */
+    for(int i = 0; i <= UCHAR_MAX; i++){
+        TASK_INDEX[i] = -1;
+    }
+
+#if TMAN_USE_DEFERRED_LOG
+    /* Logger Start */
+    memset(LOG, 0, sizeof LOG);
+#if TMAN_USE_STATIC_ALLOCATION
+    LOG_HANDLER = kernel_task_create(task_log_work, "LOG_TASK", TMAN_LOG_STACK_SIZE, NULL, TMAN_LOG_PRIORITY, LOG_STACK, &LOG_TCB);
+#else
+    LOG_HANDLER = kernel_task_create(task_log_work, "LOG_TASK", TMAN_LOG_STACK_SIZE, NULL, TMAN_LOG_PRIORITY, NULL, NULL);
+#endif
+#endif
+
+#if TMAN_USE_TRACE
+    /* Trace Start: the decoder needs the timestamp unit first */
+    trace_head = trace_tail = 0;
+    trace_dropped = trace_dropped_reported = 0;
+    trace_info(TMAN_TRACE_CLOCK, 0, TRACE_CLOCK_HZ);
+#endif
+
+    /* Tick Start */
+#if TMAN_USE_ISR_DISPATCHER
+    /* No task, the tick hook dispatches from the first kernel tick on */
+    TICK_HANDLER = NULL;
+    dispatcher_last = 0;
+    dispatcher_locked = 0;
+#elif TMAN_USE_SIMULATION
+    /* No task, the simulator runs the TMAN ticks */
+    TICK_HANDLER = NULL;
+#elif TMAN_USE_STATIC_ALLOCATION
+    TICK_HANDLER = kernel_task_create(task_tick_work, "TICK_TASK", TMAN_TICK_STACK_SIZE, NULL, TASK_TICK_PRIORITY, TICK_STACK, &TICK_TCB);
+#else
+    TICK_HANDLER = kernel_task_create(task_tick_work, "TICK_TASK", TMAN_TICK_STACK_SIZE, NULL, TASK_TICK_PRIORITY, NULL, NULL);
+#endif
+
+}
+
+/* Task id of a task name, -1 if no task has that name */
+static int task_lookup(char name)
+{
+    return TASK_INDEX[(unsigned char)name];
+}
+
+/* Attributes of a task, to undo a rejected change */
+static void attributes_save(int j, struct ATTRIBUTES *saved)
+{
+    saved->period = TASKS[j].period;
+    saved->phase = TASKS[j].phase;
+    saved->deadline = TASKS[j].deadline;
+    saved->priority = TASKS[j].priority;
+    saved->wcet_us = TASKS[j].wcet_us;
+    saved->predecessors = TASKS[j].predecessors;
+}
+
+#if TMAN_USE_ADMISSION
+static void attributes_restore(int j, const struct ATTRIBUTES *saved)
+{
+    TASKS[j].period = saved->period;
+    TASKS[j].phase = saved->phase;
+    TASKS[j].deadline = saved->deadline;
+    TASKS[j].priority = saved->priority;
+    TASKS[j].wcet_us = saved->wcet_us;
+    TASKS[j].predecessors = saved->predecessors;
+}
+#endif
+
+/* Lowest task id in a non-empty mask */
+static int mask_first(task_mask_t mask)
+{
+#if TMAN_MAX_TASKS <= 32
+    return __builtin_ctzl(mask);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+/* Registered tasks (period set) */
+static int task_registered(int id)
+{
+    return TASKS[id].period > 0;
+}
+
+#if TMAN_MAX_RESOURCES > 0
+
+/* Preemption level of a task: its priority, or in EDF mode minus its
+ * relative deadline */
+static int task_level(int id)
+{
+#if TMAN_USE_EDF
+    return -TASKS[id].deadline;
+#else
+    return TASKS[id].priority;
+#endif
+}
+
+/* Ceiling of a resource from the attributes in force */
+static int resource_ceiling(int r)
+{
+    int ceiling = INT_MIN;
+
+    for (task_mask_t mask = RESOURCES[r].users; mask != 0; mask &= mask - 1){
+        int j = mask_first(mask);
+
+        if (task_registered(j) && task_level(j) > ceiling){
+            ceiling = task_level(j);
+        }
+    }
+    return ceiling;
+}
+
+#endif /* TMAN_MAX_RESOURCES > 0 */
+
+#if TMAN_USE_AUTO_PRIORITY
+
+/* Deadline monotonic: shorter relative deadline (then shorter period)
+ * gets the higher priority */
+static void priorities_assign(void)
+{
+    int order[TMAN_MAX_TASKS];
+    int n = 0;
+    int priority = TMAN_PRIORITY_MAX;
+
+    for (int i = 0; i < task_id; i++){
+        if (task_registered(i)){
+            int k = n++;
+
+            while (k > 0 && (TASKS[order[k - 1]].deadline > TASKS[i].deadline ||
+                    (TASKS[order[k - 1]].deadline == TASKS[i].deadline && TASKS[order[k - 1]].period > TASKS[i].period))){
+                order[k] = order[k - 1];
+                k--;
+            }
+            order[k] = i;
+        }
+    }
+
+    for (int k = 0; k < n; k++){
+        struct TASK *task = &TASKS[order[k]];
+
+        if (k > 0 && priority > TMAN_PRIORITY_MIN &&
+                (task->deadline != TASKS[order[k - 1]].deadline || task->period != TASKS[order[k - 1]].period)){
+            priority--;
+        }
+        task->priority = priority;
+    }
+}
+
+#endif /* TMAN_USE_AUTO_PRIORITY */
+
+#if TMAN_USE_ADMISSION || TMAN_RUN_TIME_STATS
+/* TMAN ticks to microseconds */
+static uint64_t ticks_to_us(int tman_ticks)
+{
+    return (uint64_t)tman_ticks * TASK_TICK_PERIOD * 1000000u / TICK_PERIOD_HZ;
+}
+#endif
+
+#if TMAN_USE_ADMISSION
+
+/* Execution time used by the analysis: the declared WCET, or the largest
+ * one observed so far */
+static uint64_t task_wcet_us(int id)
+{
+    if (TASKS[id].wcet_us > 0){
+        return TASKS[id].wcet_us;
+    }
+    return stamp_to_us(TASKS[id].stats.exec_max);
+}
+
+#if TMAN_MAX_RESOURCES > 0
+
+/* Blocking of a job of task i: the longest critical section of a lower
+ * level task on a resource of ceiling at or above the level of i (with
+ * ceilings a job waits for one at most) */
+static uint64_t task_blocking_us(int i)
+{
+    uint64_t blocking = 0;
+
+    for (int r = 0; r < resource_count; r++){
+        if (resource_ceiling(r) < task_level(i)){
+            continue;
+        }
+        for (task_mask_t mask = RESOURCES[r].users & ~TASK_BIT(i); mask != 0; mask &= mask - 1){
+            int j = mask_first(mask);
+
+            if (task_registered(j) && task_level(j) < task_level(i) && (uint64_t)RESOURCES[r].cs_us[j] > blocking){
+                blocking = RESOURCES[r].cs_us[j];
+            }
+        }
+    }
+    return blocking;
+}
+
+#endif /* TMAN_MAX_RESOURCES > 0 */
+
+#if !TMAN_USE_EDF
+
+/* Release jitter of a task as seen by lower priority tasks: a deferrable
+ * server may spend its budget at the end of a period and again right at
+ * the start of the next one */
+static uint64_t task_jitter_us(int id)
+{
+#if TMAN_MAX_SERVERS > 0
+    if (TASKS[id].server != NULL && TASKS[id].server->type == TMAN_SERVER_DEFERRABLE){
+        uint64_t period = ticks_to_us(TASKS[id].period);
+        uint64_t wcet = task_wcet_us(id);
+
+        return wcet < period ? period - wcet : 0;
+    }
+#else
+    (void)id;
+#endif
+    return 0;
+}
+
+#endif
+
+#if TMAN_USE_EDF
+
+/* Window of a job of task id in the density test: min(D, T), less the
+ * wait for the pending jobs of its predecessors, each done by its own
+ * deadline (release jitter) */
+static int edf_window(int id)
+{
+    int window = TASKS[id].deadline < TASKS[id].period ? TASKS[id].deadline : TASKS[id].period;
+    int jitter = 0;
+
+    for (task_mask_t mask = TASKS[id].predecessors; mask != 0; mask &= mask - 1){
+        int p = mask_first(mask);
+
+        if (task_registered(p) && TASKS[p].deadline > jitter){
+            jitter = TASKS[p].deadline;
+        }
+    }
+    return window - jitter;
+}
+
+/* EDF density test: sum of C / min(D, T) <= 1 (exact for D >= T and no
+ * precedence) */
+static int admission_test(void)
+{
+    uint64_t density = 0;
+
+    for (int i = 0; i < task_id; i++){
+        if (task_registered(i)){
+            int window = edf_window(i);
+
+            if (window <= 0){
+                TMAN_PRINTF("TMAN: (%c) NO TIME LEFT AFTER ITS PREDECESSORS\n\r", TASKS[i].name);
+                return TMAN_FAIL;
+            }
+            density += task_wcet_us(i) * 1000000u / ticks_to_us(window);
+        }
+    }
+    if (density > 1000000u){
+        return TMAN_FAIL;
+    }
+
+#if TMAN_MAX_RESOURCES > 0
+    /* SRP (Baker): each task, blocked once by a task of longer deadline,
+     * still fits with the tasks of deadline up to its own */
+    for (int i = 0; i < task_id; i++){
+        uint64_t blocking = task_registered(i) ? task_blocking_us(i) : 0;
+
+        if (blocking == 0){
+            continue;
+        }
+        density = blocking * 1000000u / ticks_to_us(edf_window(i));
+        for (int j = 0; j < task_id; j++){
+            if (task_registered(j) && TASKS[j].deadline <= TASKS[i].deadline){
+                density += task_wcet_us(j) * 1000000u / ticks_to_us(edf_window(j));
+            }
+        }
+        if (density > 1000000u){
+            return TMAN_FAIL;
+        }
+    }
+#endif
+    return TMAN_SUCCESS;
+}
+
+#else
+
+/* Release jitter from precedence: a released job waits for the pending
+ * jobs of its predecessors, up to their response times */
+static uint64_t precedence_jitter_us(int id, const uint64_t response[])
+{
+    uint64_t jitter = 0;
+
+    for (task_mask_t mask = TASKS[id].predecessors; mask != 0; mask &= mask - 1){
+        int p = mask_first(mask);
+
+        if (task_registered(p) && response[p] > jitter){
+            jitter = response[p];
+        }
+    }
+    return jitter;
+}
+
+/* Response time analysis, synchronous release (phases are ignored, which
+ * is the worst case). Tasks of the same priority are counted as
+ * interfering with each other, lower priority tasks as blocking for one
+ * critical section on a shared resource. The wait for the predecessors is
+ * release jitter, so the response times are computed again until the
+ * jitters settle. A response time has to fit in both the deadline and the
+ * period (one job at a time). */
+static int admission_test(void)
+{
+    static uint64_t responses[TMAN_MAX_TASKS];
+    int changed = 1;
+
+    memset(responses, 0, sizeof(responses));
+    while (changed){
+        changed = 0;
+        for (int i = 0; i < task_id; i++){
+            if (!task_registered(i)){
+                continue;
+            }
+
+            uint64_t limit = ticks_to_us(TASKS[i].deadline < TASKS[i].period ? TASKS[i].deadline : TASKS[i].period);
+            uint64_t jitter = precedence_jitter_us(i, responses);
+            uint64_t wcet = task_wcet_us(i);
+            uint64_t blocking = 0;
+#if TMAN_MAX_RESOURCES > 0
+            blocking = task_blocking_us(i);
+#endif
+            uint64_t response = wcet + blocking;
+            uint64_t last = 0;
+
+            while (response != last && jitter + response <= limit){
+                last = response;
+                response = wcet + blocking;
+                for (int j = 0; j < task_id; j++){
+                    if (j != i && task_registered(j) && TASKS[j].priority >= TASKS[i].priority){
+                        uint64_t period = ticks_to_us(TASKS[j].period);
+                        uint64_t release = task_jitter_us(j) + precedence_jitter_us(j, responses);
+
+                        response += (last + release + period - 1) / period * task_wcet_us(j);
+                    }
+                }
+            }
+            response += jitter;
+            if (response > limit){
+                if (jitter > 0){
+                    TMAN_PRINTF("TMAN: (%c) LATE AFTER ITS PREDECESSORS\n\r", TASKS[i].name);
+                }
+                return TMAN_FAIL;
+            }
+            if (response != responses[i]){
+                responses[i] = response;
+                changed = 1;
+            }
+        }
+    }
+    return TMAN_SUCCESS;
+}
+
+#endif /* TMAN_USE_EDF */
+
+#endif /* TMAN_USE_ADMISSION */
+
+/* Job demoted for a budget overrun, keeps TMAN_OVERRUN_PRIORITY until it
+ * completes */
+static int task_demoted(int id)
+{
+#if TMAN_USE_BUDGET
+    return TASKS[id].demoted;
+#else
+    (void)id;
+    return 0;
+#endif
+}
+
+/* Task holding shared resources, runs at their ceiling until it unlocks
+ * them */
+static int task_holds_resources(int id)
+{
+#if TMAN_MAX_RESOURCES > 0
+    return TASKS[id].locks > 0;
+#else
+    (void)id;
+    return 0;
+#endif
+}
+
+/* Set the priorities in the kernel (in EDF mode the dispatcher does it),
+ * and the resource ceilings from them. With the tick hook dispatcher,
+ * which may get here on a mode change, each task sets its own when it
+ * next wakes up (task_wait). A task holding a resource gets its new
+ * priority when it unlocks. */
+static void priorities_apply(void)
+{
+#if TMAN_MAX_RESOURCES > 0
+    resources_update();
+#endif
+#if !TMAN_USE_EDF
+    for (int i = 0; i < task_id; i++){
+        if (task_registered(i) && TASKS[i].active_priority != TASKS[i].priority && !task_demoted(i) &&
+                !task_holds_resources(i)){
+            TASKS[i].active_priority = TASKS[i].priority;
+#if !TMAN_USE_ISR_DISPATCHER
+            vTaskPrioritySet(TASKS[i].handler, TASKS[i].priority);
+#endif
+        }
+    }
+#endif
+}
+
+/* Task j got new attributes: re-derive the automatic priorities and check
+ * the task set. A rejected change gives task j its saved attributes back. */
+static int attributes_admit(int j, const struct ATTRIBUTES *saved)
+{
+#if TMAN_USE_AUTO_PRIORITY
+    priorities_assign();
+#endif
+
+#if TMAN_USE_ADMISSION
+    if (admission_test() != TMAN_SUCCESS){
+        attributes_restore(j, saved);
+#if TMAN_USE_AUTO_PRIORITY
+        priorities_assign();
+#endif
+        TMAN_PRINTF("TMAN: (%c) REJECTED, TASK SET NOT SCHEDULABLE\n\r", TASKS[j].name);
+        return TMAN_FAIL;
+    }
+#else
+    (void)saved;
+#endif
+
+    priorities_apply();
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskSetWCET(char name, int wcet_us){
+
+    int j = task_lookup(name);
+    struct ATTRIBUTES saved;
+
+    if (j < 0 || wcet_us < 0){
+        return TMAN_FAIL;
+    }
+
+    attributes_save(j, &saved);
+    TASKS[j].wcet_us = wcet_us;
+    if (attributes_admit(j, &saved) != TMAN_SUCCESS){
+        return TMAN_FAIL;
+    }
+
+#if TMAN_USE_BUDGET
+    TASKS[j].budget = us_to_stamp(wcet_us);
+#endif
+#if TMAN_MAX_SERVERS > 0
+    /* The budget of a server is its WCET */
+    if (TASKS[j].server != NULL){
+        TASKS[j].server->budget = us_to_stamp(wcet_us);
+    }
+#endif
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskSetMissPolicy(char name, int policy){
+
+    int j = task_lookup(name);
+
+    if (j < 0 || policy < TMAN_MISS_CONTINUE || policy > TMAN_MISS_RESTART){
+        return TMAN_FAIL;
+    }
+#if TMAN_USE_ISR_DISPATCHER || !TMAN_USE_STATIC_ALLOCATION
+    /* Tasks cannot be deleted from the tick interrupt, and a task created
+     * again from the kernel heap may not get its memory back */
+    if (policy == TMAN_MISS_ABORT || policy == TMAN_MISS_RESTART){
+        return TMAN_FAIL;
+    }
+#endif
+#if TMAN_MAX_SERVERS > 0
+    /* Aborting a server would lose the aperiodic job it runs */
+    if (TASKS[j].server != NULL && (policy == TMAN_MISS_ABORT || policy == TMAN_MISS_RESTART)){
+        return TMAN_FAIL;
+    }
+#endif
+
+    TASKS[j].miss_policy = policy;
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskSetFirm(char name, int m, int k){
+
+    int j = task_lookup(name);
+
+    if (j < 0 || k < 0 || k > 32 || (k > 0 && (m < 1 || m > k))){
+        return TMAN_FAIL;
+    }
+
+    /* Updated by the dispatcher at the deadline checks */
+    taskENTER_CRITICAL();
+    TASKS[j].firm_m = m;
+    TASKS[j].firm_k = k;
+    TASKS[j].firm_history = 0;
+    TASKS[j].firm_outcomes = 0;
+    TASKS[j].firm_violations = 0;
+    taskEXIT_CRITICAL();
+    return TMAN_SUCCESS;
+}
+
+#if TMAN_USE_ISR_DISPATCHER
+
+/* Hold the tick hook dispatcher off while a task changes the attributes
+ * or the calendar; the TMAN ticks due meanwhile are dispatched at the first
+ * kernel tick after */
+static void dispatcher_lock(void)
+{
+    taskENTER_CRITICAL();
+    dispatcher_locked++;
+    taskEXIT_CRITICAL();
+}
+
+static void dispatcher_unlock(void)
+{
+    taskENTER_CRITICAL();
+    dispatcher_locked--;
+    taskEXIT_CRITICAL();
+}
+
+#endif /* TMAN_USE_ISR_DISPATCHER */
+
+int taskModifyPeriod(char name, int period){
+
+    int j = task_lookup(name);
+    struct ATTRIBUTES saved;
+
+    if (j < 0 || !attributes_valid(TASKS[j].priority, period, TASKS[j].phase, TASKS[j].deadline)){
+        return TMAN_FAIL;
+    }
+
+    DISPATCHER_LOCK();
+    attributes_save(j, &saved);
+    TASKS[j].period = period;
+    if (attributes_admit(j, &saved) != TMAN_SUCCESS){
+        DISPATCHER_UNLOCK();
+        return TMAN_FAIL;
+    }
+
+    /* A sporadic task only gets a new minimum inter-arrival time */
+    if (!TASKS[j].sporadic){
+        TASKS[j].next_release = next_release_after(&TASKS[j], TMAN_TICK);
+        TASKS[j].jitter_valid = 0;
+        calendar_update(j);
+    }
+    DISPATCHER_UNLOCK();
+
+    return TMAN_SUCCESS;
+}
+
+int taskModifyPhase(char name, int phase){
+
+    int j = task_lookup(name);
+    struct ATTRIBUTES saved;
+
+    if (j < 0 || TASKS[j].sporadic || !attributes_valid(TASKS[j].priority, TASKS[j].period, phase, TASKS[j].deadline)){
+        return TMAN_FAIL;
+    }
+
+    DISPATCHER_LOCK();
+    attributes_save(j, &saved);
+    TASKS[j].phase = phase;
+    if (attributes_admit(j, &saved) != TMAN_SUCCESS){
+        DISPATCHER_UNLOCK();
+        return TMAN_FAIL;
+    }
+
+    TASKS[j].next_release = next_release_after(&TASKS[j], TMAN_TICK);
+    TASKS[j].jitter_valid = 0;
+    calendar_update(j);
+    DISPATCHER_UNLOCK();
+
+    return TMAN_SUCCESS;
+}
+
+void TMAN_Close(void)
+{
+    /* DELETE TASKS AND EXIT */
+
+    for(int i = 0; i < task_id; i++){
+        vTaskDelete(TASKS[i].handler);
+    }
+
+    if (TICK_HANDLER != NULL){
+        vTaskDelete(TICK_HANDLER);
+    }
+#if TMAN_USE_DEFERRED_LOG
+    vTaskDelete(LOG_HANDLER);
+#endif
+    vTaskEndScheduler();
+}
+
+/* A task can be added: table not full and name not taken */
+static int task_free(char name)
+{
+    return task_id < TMAN_N_TASKS && task_lookup(name) < 0;
+}
+
+/* Create a kernel task, on the given stack and TCB with static allocation
+ * (ignored otherwise). NULL if it could not be created. */
+static TaskHandle_t kernel_task_create(TaskFunction_t work, const char *name, int stack_size, void *param,
+        UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb)
+{
+#if TMAN_USE_STATIC_ALLOCATION
+    return xTaskCreateStatic(work, name, stack_size, param, priority, stack, tcb);
+#else
+    TaskHandle_t handle;
+
+    (void)stack;
+    (void)tcb;
+    if (xTaskCreate(work, name, stack_size, param, priority, &handle) != pdPASS){
+        return NULL;
+    }
+    return handle;
+#endif
+}
+
+/* Create the kernel task of a task slot, at its active priority */
+static int task_spawn(int id)
+{
+    struct TASK *task = &TASKS[id];
+    char task_name[6] = "task";
+    StaticTask_t *tcb = NULL;
+
+#if TMAN_USE_STATIC_ALLOCATION
+    tcb = &task->tcb;
+#endif
+    task_name[4] = task->name;
+    task->handler = kernel_task_create(task->work, task_name, task->stack_size, (void *)task, task->active_priority, task->stack, tcb);
+    if (task->handler == NULL){
+        return TMAN_FAIL;
+    }
+
+    /* Tag id + 1, so the task switch hooks can tell TMAN tasks apart */
+    vTaskSetApplicationTaskTag(task->handler, (TaskHookFunction_t)(intptr_t)(id + 1));
+    return TMAN_SUCCESS;
+}
+
+/* Fill the next task slot and create its kernel task running 'work' on a
+ * stack of 'stack_size' words. Returns the task id, or TMAN_FAIL if there
+ * is no memory left for the task. */
+static int task_create(char name, TaskFunction_t work, void *server, int stack_size)
+{
+    StackType_t *stack = NULL;
+
+#if TMAN_USE_STATIC_ALLOCATION
+    if (stack_size > TMAN_STACK_POOL - stack_pool_used){
+        TMAN_PRINTF("TMAN: (%c) NO STACK LEFT IN THE POOL (TMAN_STACK_POOL)\n\r", name);
+        return TMAN_FAIL;
+    }
+    stack = &STACK_POOL[stack_pool_used];
+#endif
+
+    TASKS[task_id].name = name;
+    TASKS[task_id].work = work;
+    TASKS[task_id].stack = stack;
+    TASKS[task_id].stack_size = stack_size;
+    TASKS[task_id].deadline_misses = 0;
+    TASKS[task_id].miss_policy = TMAN_MISS_CONTINUE;
+    TASKS[task_id].skip_next = 0;
+    TASKS[task_id].aborted = 0;
+    TASKS[task_id].skipped = 0;
+    TASKS[task_id].firm_k = 0;
+    TASKS[task_id].dispatched = 0;
+    TASKS[task_id].activations = 0;
+    TASKS[task_id].next_deadline = TMAN_NO_EVENT;
+    TASKS[task_id].calendar_pos = -1;
+    TASKS[task_id].dispatching = 0;
+    TASKS[task_id].predecessors = 0;
+    TASKS[task_id].period = 0;
+    TASKS[task_id].wcet_us = 0;
+    TASKS[task_id].active_priority = tskIDLE_PRIORITY;
+    TASKS[task_id].in_job = 0;
+    TASKS[task_id].jitter_valid = 0;
+    TASKS[task_id].jobs_done = 0;
+    TASKS[task_id].sporadic = 0;
+    TASKS[task_id].arrivals = 0;
+    TASKS[task_id].arrivals_seen = 0;
+    TASKS[task_id].interarrival_violations = 0;
+#if TMAN_MAX_RESOURCES > 0
+    TASKS[task_id].locks = 0;
+    TASKS[task_id].blocked = 0;
+#endif
+#if TMAN_RUN_TIME_STATS
+    TASKS[task_id].run_time = 0;
+#endif
+#if TMAN_USE_BUDGET
+    TASKS[task_id].budget = 0;
+    TASKS[task_id].overrun = 0;
+    TASKS[task_id].overruns = 0;
+    TASKS[task_id].demoted = 0;
+    TASKS[task_id].suspended = 0;
+#endif
+    memset(&TASKS[task_id].stats, 0, sizeof TASKS[task_id].stats);
+#if TMAN_MAX_SERVERS > 0
+    TASKS[task_id].server = server;
+#else
+    (void)server;
+#endif
+    if (task_spawn(task_id) != TMAN_SUCCESS){
+        return TMAN_FAIL;
+    }
+#if TMAN_USE_STATIC_ALLOCATION
+    stack_pool_used += stack_size;
+#endif
+    TASK_INDEX[(unsigned char)name] = task_id;
+#if TMAN_USE_TRACE
+    trace_info(TMAN_TRACE_NAME, task_id, (unsigned char)name);
+#endif
+
+    return task_id++;
+
+}
+
+int TMAN_TaskAdd(char name)
+{
+    /* Create the tasks defined within this file.
+     * Returns the task id, which is also the index used in precedence
+     * lists, or TMAN_FAIL if the table is full or the name is taken. */
+
+    return TMAN_TaskAddStack(name, TMAN_STACK_SIZE);
+
+}
+
+int TMAN_TaskAddStack(char name, int stack_size)
+{
+    if (!task_free(name) || stack_size <= 0){
+        return TMAN_FAIL;
+    }
+
+    return task_create(name, task_work, NULL, stack_size);
+}
+
+#if TMAN_MAX_SERVERS > 0
+
+int TMAN_ServerAdd(char name, int type, int budget_us)
+{
+    struct SERVER *server;
+
+    if (server_count >= TMAN_MAX_SERVERS || !task_free(name) || budget_us <= 0 ||
+            (type != TMAN_SERVER_POLLING && type != TMAN_SERVER_DEFERRABLE)){
+        return TMAN_FAIL;
+    }
+
+    server = &SERVERS[server_count];
+#if TMAN_USE_STATIC_ALLOCATION
+    server->queue = xQueueCreateStatic(TMAN_SERVER_QUEUE_SIZE, sizeof(struct SERVER_REQUEST),
+            server->queue_storage, &server->queue_buffer);
+#else
+    server->queue = xQueueCreate(TMAN_SERVER_QUEUE_SIZE, sizeof(struct SERVER_REQUEST));
+#endif
+    if (server->queue == NULL){
+        return TMAN_FAIL;
+    }
+    server->type = type;
+    server->budget = us_to_stamp(budget_us);
+    server->remaining = 0;
+    server->dropped = 0;
+    server->jobs = 0;
+    server->response_min = server->response_max = 0;
+    server->response_sum = 0;
+
+    int id = task_create(name, server_work, server, TMAN_STACK_SIZE);
+    if (id < 0){
+#if !TMAN_USE_STATIC_ALLOCATION
+        vQueueDelete(server->queue);
+#endif
+        return TMAN_FAIL;
+    }
+    server_count++;
+    TASKS[id].wcet_us = budget_us;
+#if TMAN_USE_BUDGET
+    TASKS[id].budget = server->budget;
+#endif
+
+    return id;
+}
+
+/* Server of a task name, NULL if it is not a server */
+static struct SERVER *server_lookup(char name)
+{
+    int j = task_lookup(name);
+
+    return j < 0 ? NULL : TASKS[j].server;
+}
+
+int TMAN_ServerSubmit(char name, void (*job)(void *), void *arg)
+{
+    struct SERVER *server = server_lookup(name);
+    struct SERVER_REQUEST request;
+
+    if (server == NULL || job == NULL){
+        return TMAN_FAIL;
+    }
+
+    request.job = job;
+    request.arg = arg;
+    request.arrival = TMAN_TIMESTAMP();
+    if (xQueueSend(server->queue, &request, 0) != pdTRUE){
+        taskENTER_CRITICAL();
+        server->dropped++;
+        taskEXIT_CRITICAL();
+        return TMAN_FAIL;
+    }
+
+    /* A deferrable server serves it now if budget is left */
+    if (server->type == TMAN_SERVER_DEFERRABLE){
+        xTaskNotifyGive(TASKS[task_lookup(name)].handler);
+    }
+    return TMAN_SUCCESS;
+}
+
+int TMAN_ServerSubmitFromISR(char name, void (*job)(void *), void *arg, BaseType_t *higher_priority_woken)
+{
+    struct SERVER *server = server_lookup(name);
+    struct SERVER_REQUEST request;
+
+    if (server == NULL || job == NULL){
+        return TMAN_FAIL;
+    }
+
+    request.job = job;
+    request.arg = arg;
+    request.arrival = TMAN_TIMESTAMP();
+    if (xQueueSendFromISR(server->queue, &request, higher_priority_woken) != pdTRUE){
+        UBaseType_t state = taskENTER_CRITICAL_FROM_ISR();
+        server->dropped++;
+        taskEXIT_CRITICAL_FROM_ISR(state);
+        return TMAN_FAIL;
+    }
+
+    if (server->type == TMAN_SERVER_DEFERRABLE){
+        vTaskNotifyGiveFromISR(TASKS[task_lookup(name)].handler, higher_priority_woken);
+    }
+    return TMAN_SUCCESS;
+}
+
+#endif /* TMAN_MAX_SERVERS > 0 */
+
+/* Tasks reachable from 'start' through the predecessor relation */
+static task_mask_t precedence_closure(task_mask_t start)
+{
+    task_mask_t reach = start;
+    task_mask_t last = 0;
+
+    while (reach != last){
+        last = reach;
+        for (int i = 0; i < task_id; i++){
+            if (reach & TASK_BIT(i)){
+                reach |= TASKS[i].predecessors;
+            }
+        }
+    }
+    return reach;
+}
+
+/* The checks TMAN_TASK_TABLE() makes at build time, on attributes given
+ * at run time */
+static int attributes_valid(int priority, int period, int phase, int deadline)
+{
+    return period > 0 && deadline > 0 && deadline <= period && phase >= 0 && phase < period &&
+            priority < (int)configMAX_PRIORITIES - 1;
+}
+
+static int task_register(char name, int priority, int period, int phase, int deadline, int precedence_constraints[], int sporadic)
+{
+
+    int j = task_lookup(name);
+    task_mask_t predecessors = 0;
+
+    if (j < 0 || !attributes_valid(priority, period, phase, deadline)){
+        return TMAN_FAIL;
+    }
+
+    /* Predecessor ids, up to the first -1 */
+    for (int i = 0; precedence_constraints != NULL && precedence_constraints[i] != -1; i++){
+        if (precedence_constraints[i] < 0 || precedence_constraints[i] >= task_id){
+            return TMAN_FAIL;
+        }
+        predecessors |= TASK_BIT(precedence_constraints[i]);
+    }
+
+    /* The graph was acyclic before, so a new cycle has to go through j */
+    if (precedence_closure(predecessors) & TASK_BIT(j)){
+        TMAN_PRINTF("TMAN: (%c) PRECEDENCE CYCLE REJECTED\n\r", name);
+        return TMAN_FAIL;
+    }
+
+    struct ATTRIBUTES saved;
+
+    DISPATCHER_LOCK();
+    attributes_save(j, &saved);
+    TASKS[j].period = period;
+    TASKS[j].phase = phase;
+    TASKS[j].deadline = deadline;
+    TASKS[j].priority = priority;
+    TASKS[j].predecessors = predecessors;
+    if (attributes_admit(j, &saved) != TMAN_SUCCESS){
+        DISPATCHER_UNLOCK();
+        return TMAN_FAIL;
+    }
+    TASKS[j].sporadic = sporadic;
+    if (sporadic){
+        /* No release until activated, the first activation is on time */
+        SPORADIC |= TASK_BIT(j);
+        TASKS[j].next_release = TMAN_NO_EVENT;
+        TASKS[j].last_release = TMAN_TICK - period;
+        TASKS[j].arrivals_seen = TASKS[j].arrivals;
+    }
+    else {
+        SPORADIC &= ~TASK_BIT(j);
+        TASKS[j].next_release = next_release_after(&TASKS[j], TMAN_TICK);
+    }
+    calendar_update(j);
+    DISPATCHER_UNLOCK();
+
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskRegisterAttributes(char name, int priority, int period, int phase, int deadline, int precedence_constraints[])
+{
+    return task_register(name, priority, period, phase, deadline, precedence_constraints, 0);
+}
+
+int TMAN_TaskRegisterSporadic(char name, int priority, int min_interarrival, int deadline, int precedence_constraints[])
+{
+    return task_register(name, priority, min_interarrival, 0, deadline, precedence_constraints, 1);
+}
+
+/* The entries were checked at build time (TMAN_TASK_TABLE()); the
+ * precedence cycles and the task set as a whole are checked once, after
+ * all the attributes are set, and the calendar is updated once */
+int TMAN_TaskTableInit(const struct TMAN_TASK_CONFIG *table, int n)
+{
+    int base = task_id;
+    int admitted = TMAN_SUCCESS;
+
+    if (n <= 0 || base + n > TMAN_N_TASKS){
+        return TMAN_FAIL;
+    }
+
+    /* All the tasks first, a precedence may name a later one */
+    for (int i = 0; i < n; i++){
+        if (!task_free(table[i].name) || task_create(table[i].name, task_work, NULL, TMAN_STACK_SIZE) < 0){
+            return TMAN_FAIL;
+        }
+    }
+
+    DISPATCHER_LOCK();
+    for (int i = 0; i < n; i++){
+        struct TASK *task = &TASKS[base + i];
+
+        task->period = table[i].period;
+        task->phase = table[i].phase;
+        task->deadline = table[i].deadline;
+        task->priority = table[i].priority;
+        task->predecessors = (task_mask_t)(table[i].predecessors << base);
+    }
+
+    for (int j = base; j < base + n && admitted == TMAN_SUCCESS; j++){
+        if (precedence_closure(TASKS[j].predecessors) & TASK_BIT(j)){
+            TMAN_PRINTF("TMAN: (%c) PRECEDENCE CYCLE REJECTED\n\r", TASKS[j].name);
+            admitted = TMAN_FAIL;
+        }
+    }
+#if TMAN_USE_AUTO_PRIORITY
+    priorities_assign();
+#endif
+#if TMAN_USE_ADMISSION
+    if (admitted == TMAN_SUCCESS && admission_test() != TMAN_SUCCESS){
+        TMAN_PRINTF("TMAN: TASK TABLE REJECTED, TASK SET NOT SCHEDULABLE\n\r");
+        admitted = TMAN_FAIL;
+    }
+#endif
+
+    if (admitted != TMAN_SUCCESS){
+        /* Added, none registered */
+        for (int j = base; j < base + n; j++){
+            TASKS[j].period = 0;
+            TASKS[j].predecessors = 0;
+        }
+#if TMAN_USE_AUTO_PRIORITY
+        priorities_assign();
+#endif
+        DISPATCHER_UNLOCK();
+        return TMAN_FAIL;
+    }
+
+    priorities_apply();
+    for (int j = base; j < base + n; j++){
+        TASKS[j].next_release = next_release_after(&TASKS[j], TMAN_TICK);
+        calendar_place(j);
+    }
+    calendar_changed();
+    DISPATCHER_UNLOCK();
+
+    return TMAN_SUCCESS;
+}
+
+/* Record an activation; the dispatcher turns it into a release. Called
+ * inside a critical section, activations come from tasks and ISRs. */
+static void sporadic_arrival(struct TASK *task)
+{
+    task->arrival_stamp[task->arrivals % TMAN_STATS_BACKLOG] = TMAN_TIMESTAMP();
+    task->arrivals++;
+}
+
+int TMAN_TaskActivate(char name)
+{
+    int j = task_lookup(name);
+
+    if (j < 0 || !TASKS[j].sporadic || !task_registered(j)){
+        return TMAN_FAIL;
+    }
+
+    taskENTER_CRITICAL();
+    sporadic_arrival(&TASKS[j]);
+    taskEXIT_CRITICAL();
+#if TMAN_USE_TICKLESS
+    dispatcher_wake();
+#endif
+    return TMAN_SUCCESS;
+}
+
+int TMAN_TaskActivateFromISR(char name, BaseType_t *higher_priority_woken)
+{
+    int j = task_lookup(name);
+    UBaseType_t state;
+
+    if (j < 0 || !TASKS[j].sporadic || !task_registered(j)){
+        return TMAN_FAIL;
+    }
+
+    state = taskENTER_CRITICAL_FROM_ISR();
+    sporadic_arrival(&TASKS[j]);
+    taskEXIT_CRITICAL_FROM_ISR(state);
+#if TMAN_USE_TICKLESS
+    vTaskNotifyGiveFromISR(TICK_HANDLER, higher_priority_woken);
+#else
+    (void)higher_priority_woken;
+#endif
+    return TMAN_SUCCESS;
+}
+
+/* Released jobs not completed yet. The two counters have a single writer
+ * each (the dispatcher releases, the task completes), so reading the
+ * backlog needs no lock */
+static int task_backlog(int id)
+{
+    return TASKS[id].activations - TASKS[id].jobs_done;
+}
+
+/* Block until notified; 'clear' takes all the pending notifications at
+ * once instead of one */
+static void task_wait(BaseType_t clear)
+{
+#if TMAN_USE_TICKLESS
+    /* Successors held back by precedence are only re-checked by the
+     * dispatcher, which may be sleeping until the next release */
+    if (precedence_waiting > 0){
+        dispatcher_wake();
+    }
+#endif
+    ulTaskNotifyTake(clear, portMAX_DELAY);
+
+#if TMAN_USE_ISR_DISPATCHER
+    /* Priority left to the task by priorities_apply() */
+    int id = (int)(intptr_t)xTaskGetApplicationTaskTag(NULL) - 1;
+
+    if (id >= 0 && uxTaskPriorityGet(NULL) != (UBaseType_t)TASKS[id].active_priority){
+        vTaskPrioritySet(NULL, TASKS[id].active_priority);
+    }
+#endif
+}
+
+void TMAN_TaskWaitPeriod(void)
+{
+    /* Each job handed over by the dispatcher is one notification, so
+     * releases that arrive while a job is running are never lost */
+    task_wait(pdFALSE);
+}
+
+static void log_print(char type, char name, int tick)
+{
+    switch (type){
+        case LOG_JOB:
+            TMAN_PRINTF("%c, %d \n\r", name, tick);
+            break;
+        case LOG_DEADLINE_MISS:
+            TMAN_PRINTF(" --------- TASK (%c) DEADLINE MISS! \n\r", name);
+            break;
+        case LOG_OVERRUN:
+            TMAN_PRINTF(" --------- TASK (%c) BUDGET OVERRUN! \n\r", name);
+            break;
+        case LOG_MODE:
+            TMAN_PRINTF(" --------- MODE (%c) FROM TICK %d \n\r", name, tick);
+            break;
+        case LOG_FIRM:
+            TMAN_PRINTF(" --------- TASK (%c) (m,k)-FIRM VIOLATION! \n\r", name);
+            break;
+        case LOG_TT_OVERFLOW:
+            TMAN_PRINTF("TMAN: TIME-TRIGGERED TABLE DOES NOT FIT, USING THE CALENDAR\n\r");
+            break;
+    }
+}
+
+#if TMAN_USE_DEFERRED_LOG
+
+/* Queue a log record in a ring; never blocks, counts the record as
+ * dropped when the ring is full. Each ring has a single writer. */
+static void tman_log(int ring, char type, char name, int tick)
+{
+    struct LOG_RING *log = &LOG[ring];
+    unsigned head = log->head;
+
+    if (head - log->tail >= TMAN_LOG_SIZE){
+        log->dropped++;
+        return;
+    }
+
+    log->record[head & (TMAN_LOG_SIZE - 1)].type = type;
+    log->record[head & (TMAN_LOG_SIZE - 1)].name = name;
+    log->record[head & (TMAN_LOG_SIZE - 1)].tick = tick;
+    LOG_BARRIER();
+    log->head = head + 1;
+}
+
+/* Print and release the pending records of a ring */
+static void log_drain(int ring, char owner)
+{
+    struct LOG_RING *log = &LOG[ring];
+    unsigned dropped;
+
+    while (log->tail != log->head){
+        LOG_BARRIER();
+        struct LOG_RECORD record = log->record[log->tail & (TMAN_LOG_SIZE - 1)];
+        LOG_BARRIER();
+        log->tail++;
+        log_print(record.type, record.name, record.tick);
+    }
+
+    dropped = log->dropped;
+    if (dropped != log->dropped_reported){
+        TMAN_PRINTF("TMAN: (%c) %u LOG RECORDS DROPPED\n\r", owner, dropped - log->dropped_reported);
+        log->dropped_reported = dropped;
+    }
+}
+
+#if TMAN_USE_TRACE
+
+/* Append a trace record. Called with the kernel interrupts masked (inside
+ * the context switch) or through trace_put() */
+static void trace_record(int event, int task, uint32_t time)
+{
+    unsigned head = trace_head;
+    struct TRACE_RECORD *record;
+
+    if (head - trace_tail >= TMAN_TRACE_SIZE){
+        trace_dropped++;
+        return;
+    }
+
+    record = &TRACE[head & (TMAN_TRACE_SIZE - 1)];
+    record->time = time;
+    record->event = event;
+    record->task = task;
+    LOG_BARRIER();
+    trace_head = head + 1;
+}
+
+/* Trace an event from task level */
+static void trace_put(int event, int task)
+{
+    DISPATCHER_ENTER_CRITICAL();
+    trace_record(event, task, TRACE_TIME());
+    DISPATCHER_EXIT_CRITICAL();
+}
+
+/* Trace a CLOCK or NAME record, the value goes in the time field */
+static void trace_info(int event, int task, uint32_t value)
+{
+    taskENTER_CRITICAL();
+    trace_record(event, task, value);
+    taskEXIT_CRITICAL();
+}
+
+/* Send the pending trace records, up to TMAN_TRACE_FRAME_MAX per frame */
+static void trace_drain(void)
+{
+    static unsigned char frame[3 + TMAN_TRACE_FRAME_MAX * TMAN_TRACE_RECORD_SIZE + 1];
+    unsigned dropped;
+
+    while (trace_tail != trace_head){
+        unsigned char *p = frame + 3;
+        unsigned char sum = 0;
+        int n = 0;
+
+        while (n < TMAN_TRACE_FRAME_MAX && trace_tail != trace_head){
+            LOG_BARRIER();
+            struct TRACE_RECORD record = TRACE[trace_tail & (TMAN_TRACE_SIZE - 1)];
+            LOG_BARRIER();
+            trace_tail++;
+
+            *p++ = record.time;
+            *p++ = record.time >> 8;
+            *p++ = record.time >> 16;
+            *p++ = record.time >> 24;
+            *p++ = record.event;
+            *p++ = record.task;
+            n++;
+        }
+
+        frame[0] = TMAN_TRACE_SYNC0;
+        frame[1] = TMAN_TRACE_SYNC1;
+        frame[2] = n;
+        for (unsigned char *q = frame + 2; q < p; q++){
+            sum += *q;
+        }
+        *p++ = -sum;
+        TMAN_TRACE_WRITE(frame, p - frame);
+    }
+
+    dropped = trace_dropped;
+    if (dropped != trace_dropped_reported){
+        TMAN_PRINTF("TMAN: %u TRACE RECORDS DROPPED\n\r", dropped - trace_dropped_reported);
+        trace_dropped_reported = dropped;
+    }
+}
+
+#endif /* TMAN_USE_TRACE */
+
+void task_log_work(void *pvParam)
+{
+    for(;;){
+        if (stats_due){
+            stats_due = 0;
+            TMAN_TaskStats();
+        }
+        for(int i = 0; i < task_id; i++){
+            log_drain(i, TASKS[i].name);
+        }
+        log_drain(LOG_DISPATCHER, '*');
+#if TMAN_USE_TRACE
+        trace_drain();
+#endif
+
+        vTaskDelay(TMAN_LOG_PERIOD);
+    }
+}
+
+#else
+
+static void tman_log(int ring, char type, char name, int tick)
+{
+    log_print(type, name, tick);
+}
+
+#endif /* TMAN_USE_DEFERRED_LOG */
+
+#if !TMAN_USE_SIMULATION
+
+/* Periodic TMAN_TaskStats(), at most once per TMAN_STATS_PERIOD_MS
+ * however often the dispatcher wakes. The logger polls a flag, so
+ * the request never takes a slot of the dispatcher ring. */
+static void stats_request(void)
+{
+#if TMAN_STATS_PERIOD_MS > 0
+    static int stats_tick;  // TMAN tick of the last request
+
+    if ((uint64_t)(TMAN_TICK - stats_tick) * TASK_TICK_PERIOD * 1000u <
+            (uint64_t)TMAN_STATS_PERIOD_MS * TICK_PERIOD_HZ){
+        return;
+    }
+    stats_tick = TMAN_TICK;
+#if TMAN_USE_DEFERRED_LOG
+    stats_due = 1;
+#else
+    TMAN_TaskStats();
+#endif
+#endif
+}
+
+#endif
+
+/* Timestamp units to microseconds */
+static unsigned long stamp_to_us(uint64_t stamp)
+{
+    return (unsigned long)(stamp * 1000000u / TMAN_TIMESTAMP_HZ);
+}
+
+#if TMAN_MAX_SERVERS > 0 || TMAN_USE_BUDGET
+/* Microseconds to timestamp units */
+static uint32_t us_to_stamp(unsigned long us)
+{
+    return (uint32_t)((uint64_t)us * TMAN_TIMESTAMP_HZ / 1000000u);
+}
+#endif
+
+/* TMAN ticks to timestamp units */
+static uint32_t ticks_to_stamp(int tman_ticks)
+{
+    return (uint32_t)((uint64_t)tman_ticks * TASK_TICK_PERIOD * TMAN_TIMESTAMP_HZ / TICK_PERIOD_HZ);
+}
+
+#if TMAN_MAX_SERVERS > 0
+static void server_stats(struct TASK *task)
+{
+    struct SERVER *server = task->server;
+    unsigned jobs = server->jobs;
+
+    TMAN_PRINTF("TASK (%c) APERIODIC JOBS = (%u) DROPPED = (%u)\n\r", task->name, jobs, server->dropped);
+    if (jobs > 0){
+        TMAN_PRINTF("TASK (%c) APERIODIC RESPONSE TIME (us) MIN = %lu MAX = %lu MEAN = %lu\n\r", task->name,
+                stamp_to_us(server->response_min), stamp_to_us(server->response_max), stamp_to_us(server->response_sum / jobs));
+    }
+}
+#endif
+
+#if TMAN_RUN_TIME_STATS
+
+/* Run time of a task since the last reading kept in *last */
+static uint32_t run_time_delta(TaskHandle_t handle, uint32_t *last)
+{
+    TaskStatus_t status;
+    uint32_t delta;
+
+    vTaskGetInfo(handle, &status, pdFALSE, eInvalid);
+    delta = status.ulRunTimeCounter - *last;
+    *last = status.ulRunTimeCounter;
+    return delta;
+}
+
+/* part / whole in hundredths of a percent */
+static unsigned long percent_x100(uint64_t part, uint64_t whole)
+{
+    return whole == 0 ? 0 : (unsigned long)(part * 10000u / whole);
+}
+
+/* CPU used by every TMAN task, the dispatcher, the logger and idle since
+ * the last call (the 32 bit run time counters wrap, so only intervals are
+ * meaningful), against the utilization declared by the WCETs */
+static void utilization_stats(void)
+{
+    static uint32_t last_time;
+#if !TMAN_USE_ISR_DISPATCHER
+    static uint32_t last_tick;
+#endif
+#if TMAN_USE_DEFERRED_LOG
+    static uint32_t last_log;
+#endif
+    static uint32_t last_idle;
+    uint32_t now = portGET_RUN_TIME_COUNTER_VALUE();
+    uint32_t window = now - last_time;
+    uint64_t used = 0;
+    unsigned long declared = 0;
+    unsigned long share;
+
+    last_time = now;
+
+    for(int i = 0; i < task_id; i++){
+        uint32_t run = run_time_delta(TASKS[i].handler, &TASKS[i].run_time);
+
+        used += run;
+        share = percent_x100(run, window);
+        if (task_registered(i) && TASKS[i].wcet_us > 0){
+            unsigned long budget = percent_x100(TASKS[i].wcet_us, ticks_to_us(TASKS[i].period));
+
+            declared += budget;
+            TMAN_PRINTF("TASK (%c) CPU = %lu.%02lu %% DECLARED = %lu.%02lu %%\n\r", TASKS[i].name,
+                    share / 100, share % 100, budget / 100, budget % 100);
+        }
+        else {
+            TMAN_PRINTF("TASK (%c) CPU = %lu.%02lu %%\n\r", TASKS[i].name, share / 100, share % 100);
+        }
+    }
+
+    share = percent_x100(used, window);
+    TMAN_PRINTF("TMAN TASKS CPU = %lu.%02lu %% DECLARED = %lu.%02lu %%\n\r", share / 100, share % 100, declared / 100, declared % 100);
+#if !TMAN_USE_ISR_DISPATCHER
+    /* The tick hook dispatcher is charged to the tasks it interrupts */
+    share = percent_x100(run_time_delta(TICK_HANDLER, &last_tick), window);
+    TMAN_PRINTF("TMAN DISPATCHER CPU = %lu.%02lu %%\n\r", share / 100, share % 100);
+#endif
+#if TMAN_USE_DEFERRED_LOG
+    share = percent_x100(run_time_delta(LOG_HANDLER, &last_log), window);
+    TMAN_PRINTF("TMAN LOGGER CPU = %lu.%02lu %%\n\r", share / 100, share % 100);
+#endif
+    share = percent_x100(run_time_delta(xTaskGetIdleTaskHandle(), &last_idle), window);
+    TMAN_PRINTF("IDLE CPU = %lu.%02lu %%\n\r", share / 100, share % 100);
+}
+
+#endif /* TMAN_RUN_TIME_STATS */
+
+void TMAN_TaskStats(void)
+{
+    for(int i = 0; i<task_id; i++){
+
+        TMAN_PRINTF("TASK (%c) NUMBER OF ACTIVATIONS = (%d)\n\r", TASKS[i].name, TASKS[i].activations);
+        TMAN_PRINTF("TASK (%c) DEADLINE MISSES = (%d)\n\r", TASKS[i].name, TASKS[i].deadline_misses);
+#if INCLUDE_uxTaskGetStackHighWaterMark == 1
+        TMAN_PRINTF("TASK (%c) STACK (words) = %d NEVER USED = %u\n\r", TASKS[i].name, TASKS[i].stack_size,
+                (unsigned)uxTaskGetStackHighWaterMark(TASKS[i].handler));
+#endif
+#if TMAN_USE_BUDGET
+        if (TASKS[i].budget != 0){
+            TMAN_PRINTF("TASK (%c) BUDGET OVERRUNS = (%d)\n\r", TASKS[i].name, TASKS[i].overruns);
+        }
+#endif
+        if (TASKS[i].miss_policy != TMAN_MISS_CONTINUE){
+            TMAN_PRINTF("TASK (%c) ABORTED JOBS = (%d) SKIPPED RELEASES = (%d)\n\r", TASKS[i].name, TASKS[i].aborted, TASKS[i].skipped);
+        }
+        if (TASKS[i].firm_k > 0){
+            TMAN_PRINTF("TASK (%c) (%d,%d)-FIRM VIOLATIONS = (%d)\n\r", TASKS[i].name, TASKS[i].firm_m, TASKS[i].firm_k, TASKS[i].firm_violations);
+        }
+        if (TASKS[i].sporadic){
+            TMAN_PRINTF("TASK (%c) ARRIVALS = (%u) INTER-ARRIVAL VIOLATIONS = (%d)\n\r", TASKS[i].name,
+                    TASKS[i].arrivals, TASKS[i].interarrival_violations);
+        }
+#if TMAN_MAX_SERVERS > 0
+        if (TASKS[i].server != NULL){
+            server_stats(&TASKS[i]);
+        }
+#endif
+
+        /* Snapshot, the task may complete a job while printing */
+        struct JOB_STATS stats = TASKS[i].stats;
+        if (stats.jobs == 0){
+            continue;
+        }
+
+        TMAN_PRINTF("TASK (%c) RESPONSE TIME (us) MIN = %lu MAX = %lu MEAN = %lu\n\r", TASKS[i].name,
+                stamp_to_us(stats.response_min), stamp_to_us(stats.response_max), stamp_to_us(stats.response_sum / stats.jobs));
+        TMAN_PRINTF("TASK (%c) START LATENCY (us) MIN = %lu MAX = %lu MEAN = %lu\n\r", TASKS[i].name,
+                stamp_to_us(stats.latency_min), stamp_to_us(stats.latency_max), stamp_to_us(stats.latency_sum / stats.jobs));
+#if TMAN_MAX_RESOURCES > 0
+        if (resource_count > 0){
+            TMAN_PRINTF("TASK (%c) BLOCKING (us) MIN = %lu MAX = %lu MEAN = %lu\n\r", TASKS[i].name,
+                    stamp_to_us(stats.blocking_min), stamp_to_us(stats.blocking_max), stamp_to_us(stats.blocking_sum / stats.jobs));
+        }
+#endif
+        TMAN_PRINTF("TASK (%c) EXECUTION TIME (us) MIN = %lu MAX = %lu MEAN = %lu\n\r", TASKS[i].name,
+                stamp_to_us(stats.exec_min), stamp_to_us(stats.exec_max), stamp_to_us(stats.exec_sum / stats.jobs));
+        TMAN_PRINTF("TASK (%c) RELEASE JITTER (us) = %lu\n\r", TASKS[i].name, stamp_to_us(stats.jitter_max));
+
+        TMAN_PRINTF("TASK (%c) RESPONSE / DEADLINE (1/%d) =", TASKS[i].name, TMAN_STATS_BUCKETS);
+        for(int b = 0; b < TMAN_STATS_BUCKETS; b++){
+            TMAN_PRINTF(" %u", stats.histogram[b]);
+        }
+        TMAN_PRINTF(" | LATE %u\n\r", stats.histogram[TMAN_STATS_BUCKETS]);
+    }
+
+#if TMAN_MAX_RESOURCES > 0
+    for(int r = 0; r < resource_count; r++){
+        struct RESOURCE *res = &RESOURCES[r];
+
+        /* Not used by a registered task */
+        if (res->ceiling == INT_MIN){
+            continue;
+        }
+#if TMAN_USE_EDF
+        TMAN_PRINTF("RESOURCE (%c) CEILING (deadline) = %d LOCKS = (%u) LONGEST HOLD (us) = %lu\n\r", res->name,
+                -res->ceiling, res->locks, stamp_to_us(res->held_max));
+#else
+        TMAN_PRINTF("RESOURCE (%c) CEILING = %d LOCKS = (%u) LONGEST HOLD (us) = %lu\n\r", res->name,
+                res->ceiling, res->locks, stamp_to_us(res->held_max));
+#endif
+    }
+#endif
+
+#if TMAN_MAX_MODES > 0
+    if (mode_changes > 0){
+        TMAN_PRINTF("TMAN MODE (%c) CHANGES = (%d) MAX DELAY (ticks) = %d\n\r", TMAN_ModeCurrent(), mode_changes, mode_delay_max);
+    }
+#endif
+
+#if TMAN_RUN_TIME_STATS
+    utilization_stats();
+#endif
+}
+
+/* Add a sample to a min/max/sum triple ('jobs' samples so far) */
+static void stats_add(uint32_t *min, uint32_t *max, uint64_t *sum, uint32_t value, unsigned jobs)
+{
+    if (jobs == 0 || value < *min){
+        *min = value;
+    }
+    if (value > *max){
+        *max = value;
+    }
+    *sum += value;
+}
+
+/*
+ * Job accounting. The running job of a task collects its execution time
+ * between the switch hooks; start and end are marked by the task itself,
+ * inside a critical section so no switch hook sees half of it.
+ */
+static void job_start(struct TASK *task)
+{
+    taskENTER_CRITICAL();
+    task->job_start = TMAN_TIMESTAMP();
+    task->switched_in = task->job_start;
+    task->exec = 0;
+#if TMAN_USE_BUDGET
+    task->budget_limit = task->budget;
+    task->overrun = 0;
+#endif
+    task->in_job = 1;
+#if TMAN_USE_TRACE
+    trace_record(TMAN_TRACE_START, task - TASKS, TRACE_TIME());
+#endif
+    taskEXIT_CRITICAL();
+}
+
+static void job_end(struct TASK *task)
+{
+    struct JOB_STATS *stats = &task->stats;
+    uint32_t end, release, response, latency, exec;
+    int backlog;
+    unsigned bucket;
+#if TMAN_MAX_RESOURCES > 0
+    uint32_t blocking;
+#endif
+
+    taskENTER_CRITICAL();
+    end = TMAN_TIMESTAMP();
+    task->exec += end - task->switched_in;
+    task->in_job = 0;
+#if TMAN_USE_TRACE
+    trace_record(TMAN_TRACE_END, task - TASKS, TRACE_TIME());
+#endif
+    backlog = task->activations - task->jobs_done;
+    release = task->release_stamp[task->jobs_done % TMAN_STATS_BACKLOG];
+    task->jobs_done++;
+    if (backlog == 1){
+        PENDING &= ~TASK_BIT(task - TASKS);
+    }
+#if TMAN_MAX_RESOURCES > 0
+    blocking = task->blocked;
+    task->blocked = 0;
+#endif
+    taskEXIT_CRITICAL();
+
+#if TMAN_USE_BUDGET && TMAN_OVERRUN_POLICY == TMAN_OVERRUN_DEMOTE
+    /* Back to the task priority; in EDF mode the lowest of the band until
+     * the dispatcher ranks the task again */
+    if (task->demoted){
+#if TMAN_USE_EDF
+        task->active_priority = TMAN_PRIORITY_MIN;
+#else
+        task->active_priority = task->priority;
+#endif
+        task->demoted = 0;
+        vTaskPrioritySet(NULL, task->active_priority);
+    }
+#endif
+
+#if TMAN_USE_EDF
+    /* The next job of the backlog has a later deadline: rank the task
+     * again now, not at the next release */
+    if (backlog > 1){
+        taskENTER_CRITICAL();
+        edf_assign_priorities();
+        taskEXIT_CRITICAL();
+    }
+#endif
+
+    /* The release of this job was already overwritten, skip it */
+    if (backlog > TMAN_STATS_BACKLOG){
+        return;
+    }
+
+    response = end - release;
+    latency = task->job_start - release;
+    exec = task->exec;
+
+    stats_add(&stats->response_min, &stats->response_max, &stats->response_sum, response, stats->jobs);
+    stats_add(&stats->latency_min, &stats->latency_max, &stats->latency_sum, latency, stats->jobs);
+#if TMAN_MAX_RESOURCES > 0
+    stats_add(&stats->blocking_min, &stats->blocking_max, &stats->blocking_sum, blocking, stats->jobs);
+#endif
+    stats_add(&stats->exec_min, &stats->exec_max, &stats->exec_sum, exec, stats->jobs);
+
+    uint32_t deadline = ticks_to_stamp(task->deadline);
+    bucket = TMAN_STATS_BUCKETS;
+    if (response < deadline){
+        bucket = (uint64_t)response * TMAN_STATS_BUCKETS / deadline;
+    }
+    stats->histogram[bucket]++;
+    stats->jobs++;
+}
+
+#if TMAN_USE_BUDGET
+
+/* Flag an overrun of the job of a task that has run 'running' time units
+ * since its last switch in. Called from the kernel hooks (interrupts
+ * masked); the dispatcher applies the policy. */
+static void budget_check(int task, uint32_t running)
+{
+    struct TASK *t = &TASKS[task];
+
+    if (t->in_job && t->budget != 0 && !t->overrun && t->exec + running > t->budget_limit){
+        t->overrun = 1;
+        t->overruns++;
+        OVERRUN |= TASK_BIT(task);
+#if TMAN_USE_TRACE
+        trace_record(TMAN_TRACE_OVERRUN, task, TRACE_TIME());
+#endif
+    }
+}
+
+void TMAN_TickHook(void)
+{
+    int task = RUNNING;
+
+    if (task >= 0){
+        budget_check(task, TMAN_TIMESTAMP() - TASKS[task].switched_in);
+    }
+
+    /* The dispatcher preempts the overrunning job as soon as the tick
+     * interrupt returns */
+    if (OVERRUN != 0 && TICK_HANDLER != NULL){
+        vTaskNotifyGiveFromISR(TICK_HANDLER, NULL);
+    }
+}
+
+/* Apply the overrun policy to the jobs flagged by the hooks */
+static void budget_enforce(void)
+{
+    task_mask_t overruns;
+
+    taskENTER_CRITICAL();
+    overruns = OVERRUN;
+    OVERRUN = 0;
+    taskEXIT_CRITICAL();
+
+    for (; overruns != 0; overruns &= overruns - 1){
+        int task = mask_first(overruns);
+
+        tman_log(LOG_DISPATCHER, LOG_OVERRUN, TASKS[task].name, TMAN_TICK);
+        if (!TASKS[task].in_job){
+            continue;
+        }
+        /* Demoted or suspended holding a resource, the job would block the
+         * tasks sharing it past one critical section: only counted */
+        if (task_holds_resources(task)){
+            continue;
+        }
+#if TMAN_OVERRUN_POLICY == TMAN_OVERRUN_DEMOTE
+        TASKS[task].demoted = 1;
+        TASKS[task].active_priority = TMAN_OVERRUN_PRIORITY;
+        vTaskPrioritySet(TASKS[task].handler, TMAN_OVERRUN_PRIORITY);
+#elif TMAN_OVERRUN_POLICY == TMAN_OVERRUN_SUSPEND
+        TASKS[task].suspended = 1;
+        vTaskSuspend(TASKS[task].handler);
+#endif
+    }
+}
+
+#else
+
+void TMAN_TickHook(void)
+{
+#if TMAN_USE_ISR_DISPATCHER
+    tick_dispatch();
+#endif
+}
+
+#endif /* TMAN_USE_BUDGET */
+
+void TMAN_TraceSwitchedOut(void *tag)
+{
+    int task = (int)(intptr_t)tag - 1;
+
+    if (task >= 0 && TASKS[task].in_job){
+        TASKS[task].exec += TMAN_TIMESTAMP() - TASKS[task].switched_in;
+#if TMAN_USE_BUDGET
+        budget_check(task, 0);
+#endif
+#if TMAN_USE_TRACE
+        trace_record(TMAN_TRACE_PREEMPT, task, TRACE_TIME());
+#endif
+    }
+}
+
+void TMAN_TraceSwitchedIn(void *tag)
+{
+    int task = (int)(intptr_t)tag - 1;
+
+#if TMAN_USE_BUDGET
+    RUNNING = task;
+#endif
+    if (task >= 0 && TASKS[task].in_job){
+        TASKS[task].switched_in = TMAN_TIMESTAMP();
+#if TMAN_USE_TRACE
+        trace_record(TMAN_TRACE_RESUME, task, TRACE_TIME());
+#endif
+    }
+}
+
+/* First tick after 'tick' where ((tick - release_origin) % period) == phase */
+static int next_release_after(struct TASK *task, int tick)
+{
+    int release = tick - ((tick - release_origin) % task->period) + task->phase;
+
+    while (release <= tick){
+        release += task->period;
+    }
+    return release;
+}
+
+static int calendar_key(int id)
+{
+    if (TASKS[id].next_deadline < TASKS[id].next_release){
+        return TASKS[id].next_deadline;
+    }
+    return TASKS[id].next_release;
+}
+
+static void calendar_swap(int a, int b)
+{
+    int id = CALENDAR[a];
+
+    CALENDAR[a] = CALENDAR[b];
+    CALENDAR[b] = id;
+    TASKS[CALENDAR[a]].calendar_pos = a;
+    TASKS[CALENDAR[b]].calendar_pos = b;
+}
+
+static void calendar_sift_up(int pos)
+{
+    while (pos > 0 && calendar_key(CALENDAR[pos]) < calendar_key(CALENDAR[(pos - 1) / 2])){
+        calendar_swap(pos, (pos - 1) / 2);
+        pos = (pos - 1) / 2;
+    }
+}
+
+static void calendar_sift_down(int pos)
+{
+    for(;;){
+        int first = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+
+        if (left < calendar_size && calendar_key(CALENDAR[left]) < calendar_key(CALENDAR[first])){
+            first = left;
+        }
+        if (right < calendar_size && calendar_key(CALENDAR[right]) < calendar_key(CALENDAR[first])){
+            first = right;
+        }
+        if (first == pos){
+            return;
+        }
+        calendar_swap(pos, first);
+        pos = first;
+    }
+}
+
+/* Insert a task in the calendar or move it after its events changed */
+static void calendar_place(int id)
+{
+    int pos = TASKS[id].calendar_pos;
+
+    if (pos < 0){
+        pos = calendar_size++;
+        CALENDAR[pos] = id;
+        TASKS[id].calendar_pos = pos;
+    }
+    calendar_sift_up(pos);
+    calendar_sift_down(TASKS[id].calendar_pos);
+}
+
+/* Bring the dispatcher up to date with the calendar */
+static void calendar_changed(void)
+{
+#if TMAN_USE_TIME_TRIGGERED
+    tt_build();
+#endif
+#if TMAN_USE_TICKLESS
+    dispatcher_wake();
+#endif
+}
+
+static void calendar_update(int id)
+{
+    calendar_place(id);
+    calendar_changed();
+}
+
+#if TMAN_USE_TIME_TRIGGERED || TMAN_MAX_MODES > 0
+
+/* Restore the heap order after the keys of many tasks changed */
+static void calendar_rebuild(void)
+{
+    for (int pos = calendar_size / 2 - 1; pos >= 0; pos--){
+        calendar_sift_down(pos);
+    }
+}
+
+static int gcd(int a, int b)
+{
+    while (b != 0){
+        int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/* Least common multiple of the periods of the registered periodic tasks
+ * (1 if none), 0 if it is above 'limit' */
+static int task_hyperperiod(int limit)
+{
+    long long hyperperiod = 1;
+
+    for (int i = 0; i < task_id; i++){
+        if (task_registered(i) && !TASKS[i].sporadic){
+            hyperperiod = hyperperiod / gcd((int)hyperperiod, TASKS[i].period) * TASKS[i].period;
+            if (hyperperiod > limit){
+                return 0;
+            }
+        }
+    }
+    return (int)hyperperiod;
+}
+
+#endif
+
+#if TMAN_USE_TIME_TRIGGERED
+
+/* Go back to the calendar. While it is not used its heap order goes stale
+ * (the release code still moves the keys), so it is rebuilt. */
+static void tt_stop(void)
+{
+    calendar_rebuild();
+    tt_slots = 0;
+}
+
+/* Lay out the releases and deadline checks of one hyperperiod */
+static void tt_build(void)
+{
+    int hyperperiod;
+    int slots = 0;
+    int fits = 1;
+
+    /* Sporadic releases are not known in advance */
+    if (SPORADIC != 0){
+        if (tt_slots > 0){
+            tt_stop();
+        }
+        return;
+    }
+
+    hyperperiod = task_hyperperiod(TMAN_TT_MAX_HYPERPERIOD);
+
+    for (int t = 0; t < hyperperiod; t++){
+        task_mask_t releases = 0;
+        task_mask_t deadlines = 0;
+
+        for (int i = 0; i < task_id; i++){
+            if (task_registered(i)){
+                int period = TASKS[i].period;
+                int phase = TASKS[i].phase;   // below the period
+
+                if (t % period == phase){
+                    releases |= TASK_BIT(i);
+                }
+                if (((t - phase - TASKS[i].deadline) % period + period) % period == 0){
+                    deadlines |= TASK_BIT(i);
+                }
+            }
+        }
+        if (releases == 0 && deadlines == 0){
+            continue;
+        }
+        if (slots == TMAN_TT_TABLE_SIZE){
+            fits = 0;
+            break;
+        }
+        TT_TABLE[slots].tick = t;
+        TT_TABLE[slots].releases = releases;
+        TT_TABLE[slots].deadlines = deadlines;
+        slots++;
+    }
+
+    if (hyperperiod == 0){
+        fits = 0;
+    }
+    if (!fits || slots == 0){
+        if (!fits){
+#if TMAN_USE_DEFERRED_LOG
+            /* Also built from task level, while the dispatcher may be
+             * writing its ring */
+            DISPATCHER_ENTER_CRITICAL();
+            tman_log(LOG_DISPATCHER, LOG_TT_OVERFLOW, 0, TMAN_TICK);
+            DISPATCHER_EXIT_CRITICAL();
+#else
+            tman_log(LOG_DISPATCHER, LOG_TT_OVERFLOW, 0, TMAN_TICK);
+#endif
+        }
+        tt_stop();
+        return;
+    }
+
+    /* Continue after the current tick, as the calendar does */
+    tt_hyperperiod = hyperperiod;
+    tt_base = TMAN_TICK - (TMAN_TICK - release_origin) % hyperperiod;
+    tt_next = 0;
+    while (tt_next < slots && tt_base + TT_TABLE[tt_next].tick <= TMAN_TICK){
+        tt_next++;
+    }
+    if (tt_next == slots){
+        tt_next = 0;
+        tt_base += hyperperiod;
+    }
+    tt_slots = slots;
+}
+
+/* Handle the table slots due on this tick, deadline checks first. Returns
+ * 1 if jobs were released. */
+static int tt_dispatch(void)
+{
+    int released = 0;
+
+    while (tt_base + TT_TABLE[tt_next].tick <= TMAN_TICK){
+        struct TT_SLOT *slot = &TT_TABLE[tt_next];
+
+        for (task_mask_t mask = slot->deadlines; mask != 0; mask &= mask - 1){
+            deadline_check(mask_first(mask));
+        }
+        for (task_mask_t mask = slot->releases; mask != 0; mask &= mask - 1){
+            job_release(mask_first(mask), TMAN_TIMESTAMP());
+            released = 1;
+        }
+
+        if (++tt_next == tt_slots){
+            tt_next = 0;
+            tt_base += tt_hyperperiod;
+        }
+    }
+    return released;
+}
+
+#endif /* TMAN_USE_TIME_TRIGGERED */
+
+#if TMAN_USE_EDF
+
+/* Absolute deadline (TMAN tick) of the oldest pending job of a task, from
+ * its release tick (skipped releases leave gaps in a backlog). Beyond the
+ * last TMAN_STATS_BACKLOG releases, the older jobs are taken as released
+ * one period apart. */
+static int edf_deadline(int id)
+{
+    struct TASK *t = &TASKS[id];
+    int backlog = task_backlog(id);
+    int kept = backlog < TMAN_STATS_BACKLOG ? backlog : TMAN_STATS_BACKLOG;
+
+    if (backlog == 0){
+        /* Holding a resource between jobs: the deadline of the next job */
+        return (t->sporadic ? t->last_release + t->period : t->next_release) + t->deadline;
+    }
+    return t->release_tick[(t->activations - kept) % TMAN_STATS_BACKLOG] - (backlog - kept) * t->period +
+            t->deadline;
+}
+
+/* Sort the tasks with pending jobs (and the holders of resources) by
+ * absolute deadline and map them on the EDF priority band, earliest
+ * deadline on top */
+static void edf_assign_priorities(void)
+{
+    int order[TMAN_MAX_TASKS];
+    int key[TMAN_MAX_TASKS];
+    int back[TMAN_MAX_TASKS];
+    int n = 0;
+    int priority = TMAN_PRIORITY_MAX;
+#if TMAN_MAX_RESOURCES > 0
+    int ceiling = resource_system_ceiling();
+#endif
+
+    for (int i = 0; i < task_id; i++){
+        if ((PENDING & TASK_BIT(i)) || task_holds_resources(i)){
+            int deadline = edf_deadline(i);
+            int held_back = 0;
+            int k = n++;
+
+#if TMAN_MAX_RESOURCES > 0
+            /* SRP: a job that may not preempt the system ceiling (the
+             * highest ceiling of the locked resources) ranks below the
+             * others until the ceiling drops */
+            held_back = !task_holds_resources(i) && task_level(i) <= ceiling;
+#endif
+            while (k > 0 && (back[k - 1] > held_back || (back[k - 1] == held_back && key[k - 1] > deadline))){
+                order[k] = order[k - 1];
+                key[k] = key[k - 1];
+                back[k] = back[k - 1];
+                k--;
+            }
+            order[k] = i;
+            key[k] = deadline;
+            back[k] = held_back;
+        }
+    }
+
+    for (int k = 0; k < n; k++){
+        if (k > 0 && (key[k] != key[k - 1] || back[k] != back[k - 1]) && priority > TMAN_PRIORITY_MIN){
+            priority--;
+        }
+        if (TASKS[order[k]].active_priority != priority && !task_demoted(order[k])){
+            TASKS[order[k]].active_priority = priority;
+            vTaskPrioritySet(TASKS[order[k]].handler, priority);
+        }
+    }
+}
+
+#endif /* TMAN_USE_EDF */
+
+/* Add a deadline, met or not, to the (m,k)-firm history of a task */
+static void firm_record(int task, int met)
+{
+    struct TASK *t = &TASKS[task];
+
+    if (t->firm_k == 0){
+        return;
+    }
+
+    t->firm_history = t->firm_history << 1 | (uint32_t)met;
+    if (t->firm_k < 32){
+        t->firm_history &= ((uint32_t)1 << t->firm_k) - 1;
+    }
+    if (t->firm_outcomes < t->firm_k){
+        t->firm_outcomes++;
+    }
+    if (t->firm_outcomes == t->firm_k && __builtin_popcount(t->firm_history) < t->firm_m){
+        t->firm_violations++;
+        tman_log(LOG_DISPATCHER, LOG_FIRM, t->name, TMAN_TICK);
+    }
+}
+
+/* Drop the oldest 'jobs' pending jobs of a task, the running one included.
+ * The kernel task is deleted (it is not running, the dispatcher is) and
+ * created again on its memory, starting over from its function; the jobs
+ * it had been handed and did not start are handed to it again. */
+static void job_abort(int task, int jobs)
+{
+    struct TASK *t = &TASKS[task];
+
+    vTaskDelete(t->handler);
+
+    taskENTER_CRITICAL();
+    t->in_job = 0;
+    t->jobs_done += jobs;
+    if (t->dispatched < t->jobs_done){
+        t->dispatched = t->jobs_done;
+    }
+    if (t->jobs_done == t->activations){
+        PENDING &= ~TASK_BIT(task);
+    }
+#if TMAN_USE_BUDGET
+    t->overrun = 0;
+    t->suspended = 0;
+    OVERRUN &= ~TASK_BIT(task);
+#endif
+#if TMAN_MAX_RESOURCES > 0
+    /* The resources of the job are given back, the task starts over from
+     * its own priority */
+    if (t->locks > 0){
+        while (t->locks > 0){
+            resource_release(task);
+        }
+#if TMAN_USE_EDF
+        t->active_priority = TMAN_PRIORITY_MIN;
+#else
+        t->active_priority = t->priority;
+#endif
+    }
+    t->blocked = 0;
+#endif
+    taskEXIT_CRITICAL();
+
+#if TMAN_USE_BUDGET
+    if (t->demoted){
+#if TMAN_USE_EDF
+        t->active_priority = TMAN_PRIORITY_MIN;
+#else
+        t->active_priority = t->priority;
+#endif
+        t->demoted = 0;
+    }
+#endif
+
+    t->aborted += jobs;
+    for (int i = 0; i < jobs; i++){
+        TRACE(TMAN_TRACE_ABORT, task);
+    }
+
+    /* Same memory and priority: the ABORT and RESTART policies are only
+     * taken with static allocation, where this cannot fail */
+    if (task_spawn(task) != TMAN_SUCCESS){
+        configASSERT(0);
+        return;
+    }
+    for (int i = t->jobs_done; i < t->dispatched; i++){
+        xTaskNotifyGive(t->handler);
+    }
+#if TMAN_USE_EDF && TMAN_MAX_RESOURCES > 0
+    /* The system ceiling may have dropped */
+    edf_assign_priorities();
+#endif
+}
+
+/* Deadline check of the last released job of a task (none if no job was
+ * released since the last check, e.g. a skipped release in the
+ * time-triggered table) */
+static void deadline_check(int task)
+{
+    if (TASKS[task].next_deadline == TMAN_NO_EVENT){
+        return;
+    }
+    TASKS[task].next_deadline = TMAN_NO_EVENT;
+
+    if (task_backlog(task) == 0){
+        firm_record(task, 1);
+        return;
+    }
+
+    TRACE(TMAN_TRACE_MISS, task);
+    tman_log(LOG_DISPATCHER, LOG_DEADLINE_MISS, TASKS[task].name, TMAN_TICK);
+    TASKS[task].deadline_misses += 1;
+    firm_record(task, 0);
+
+    switch (TASKS[task].miss_policy){
+        case TMAN_MISS_ABORT:
+            job_abort(task, 1);
+            break;
+        case TMAN_MISS_SKIP:
+            TASKS[task].skip_next = 1;
+            break;
+        case TMAN_MISS_RESTART:
+            job_abort(task, task_backlog(task));
+            break;
+    }
+}
+
+/* Skip a release of a task (TMAN_MISS_SKIP): its time goes to the late
+ * job, and it counts as a missed deadline for the (m,k)-firm constraint */
+static void release_skip(int task)
+{
+    TASKS[task].skip_next = 0;
+    TASKS[task].skipped++;
+    TASKS[task].jitter_valid = 0;
+    firm_record(task, 0);
+    if (TASKS[task].sporadic){
+        TASKS[task].last_release = TASKS[task].next_release;
+        TASKS[task].next_release = TMAN_NO_EVENT;
+    }
+    else {
+        TASKS[task].next_release += TASKS[task].period;
+    }
+}
+
+/* Release the next job of a task, timed from 'now' */
+static void job_release(int task, uint32_t now)
+{
+    uint32_t *stamp = TASKS[task].release_stamp;
+    int n = TASKS[task].activations;
+
+    if (TASKS[task].skip_next){
+        release_skip(task);
+        return;
+    }
+
+    /* Release jitter: error of the interval since the last release */
+    if (TASKS[task].jitter_valid){
+        uint32_t interval = now - stamp[(n - 1) % TMAN_STATS_BACKLOG];
+        uint32_t period = ticks_to_stamp(TASKS[task].period);
+        uint32_t error = interval > period ? interval - period : period - interval;
+
+        if (error > TASKS[task].stats.jitter_max){
+            TASKS[task].stats.jitter_max = error;
+        }
+    }
+    stamp[n % TMAN_STATS_BACKLOG] = now;
+    TASKS[task].jitter_valid = !TASKS[task].sporadic;
+
+#if TMAN_USE_BUDGET
+    /* A job suspended for an overrun goes on with one more budget */
+    if (TASKS[task].suspended){
+        TASKS[task].suspended = 0;
+        TASKS[task].budget_limit += TASKS[task].budget;
+        TASKS[task].overrun = 0;
+        vTaskResume(TASKS[task].handler);
+    }
+#endif
+
+#if TMAN_USE_EDF
+    TASKS[task].release_tick[n % TMAN_STATS_BACKLOG] = TASKS[task].next_release;
+#endif
+
+    TRACE(TMAN_TRACE_RELEASE, task);
+    DISPATCHER_ENTER_CRITICAL();
+    TASKS[task].activations += 1;
+    PENDING |= TASK_BIT(task);
+    DISPATCHER_EXIT_CRITICAL();
+    TASKS[task].next_deadline = TASKS[task].next_release + TASKS[task].deadline;
+    if (TASKS[task].sporadic){
+        TASKS[task].last_release = TASKS[task].next_release;
+        TASKS[task].next_release = TMAN_NO_EVENT;
+    }
+    else {
+        TASKS[task].next_release += TASKS[task].period;
+    }
+    if (!TASKS[task].dispatching){
+        TASKS[task].dispatching = 1;
+        DISPATCH[dispatch_size++] = task;
+    }
+}
+
+/* Handle the calendar events due on this tick: deadline checks first, so a
+ * job still running when its next period starts (deadline == period) is
+ * reported, then the releases. Returns 1 if jobs were released. */
+static int calendar_dispatch(void)
+{
+    int released = 0;
+
+    while (calendar_size > 0 && calendar_key(CALENDAR[0]) <= TMAN_TICK){
+        int task = CALENDAR[0];
+
+        if (TASKS[task].next_deadline <= TMAN_TICK){
+            deadline_check(task);
+        }
+        if (TASKS[task].next_release <= TMAN_TICK){
+            job_release(task, TMAN_TIMESTAMP());
+            released = 1;
+        }
+
+        calendar_sift_down(0);
+    }
+    return released;
+}
+
+/* Turn the activations of the sporadic tasks into releases: at once when
+ * the minimum inter-arrival time since the last release has passed, else
+ * counted and (TMAN_SPORADIC_DEFER) put in the calendar for when it has.
+ * A task with a deferred release takes no more activations until then.
+ * Returns 1 if jobs were released. */
+static int sporadic_dispatch(void)
+{
+    int released = 0;
+
+    for (task_mask_t mask = SPORADIC; mask != 0; mask &= mask - 1){
+        int task = mask_first(mask);
+        struct TASK *t = &TASKS[task];
+
+        while (t->arrivals_seen != t->arrivals && t->next_release == TMAN_NO_EVENT){
+            /* Timed from the activation, unless its stamp was overwritten */
+            uint32_t stamp = t->arrivals - t->arrivals_seen <= TMAN_STATS_BACKLOG ?
+                    t->arrival_stamp[t->arrivals_seen % TMAN_STATS_BACKLOG] : TMAN_TIMESTAMP();
+
+            t->arrivals_seen++;
+            if (TMAN_TICK - t->last_release < t->period){
+                t->interarrival_violations++;
+#if TMAN_SPORADIC_DEFER
+                t->next_release = t->last_release + t->period;
+                calendar_update(task);
+                break;
+#endif
+            }
+            t->next_release = TMAN_TICK;
+            job_release(task, stamp);
+            calendar_update(task);
+            released = 1;
+        }
+    }
+    return released;
+}
+
+#if TMAN_MAX_MODES > 0
+
+/* Mode index of a mode name, -1 if there is none */
+static int mode_lookup(char name)
+{
+    for (int m = 0; m < mode_count; m++){
+        if (MODES[m].name == name){
+            return m;
+        }
+    }
+    return -1;
+}
+
+int TMAN_ModeAdd(char name)
+{
+    if (mode_count >= TMAN_MAX_MODES || mode_lookup(name) >= 0){
+        return TMAN_FAIL;
+    }
+
+    MODES[mode_count].name = name;
+    MODES[mode_count].tasks = 0;
+    return mode_count++;
+}
+
+int TMAN_ModeTask(char mode, char name, int priority, int period, int phase, int deadline)
+{
+    int m = mode_lookup(mode);
+    int j = task_lookup(name);
+
+    /* A pending change reads the mode from the dispatcher */
+    if (m < 0 || j < 0 || !attributes_valid(priority, period, phase, deadline) || m == mode_requested){
+        return TMAN_FAIL;
+    }
+
+    MODES[m].task[j].priority = priority;
+    MODES[m].task[j].period = period;
+    MODES[m].task[j].phase = TASKS[j].sporadic ? 0 : phase;
+    MODES[m].task[j].deadline = deadline;
+    MODES[m].tasks |= TASK_BIT(j);
+    return TMAN_SUCCESS;
+}
+
+/* Give task j its attributes in a mode (period 0, not registered, if the
+ * mode stops it) */
+static void mode_attributes(const struct MODE *mode, int j)
+{
+    if (mode->tasks & TASK_BIT(j)){
+        TASKS[j].priority = mode->task[j].priority;
+        TASKS[j].period = mode->task[j].period;
+        TASKS[j].phase = mode->task[j].phase;
+        TASKS[j].deadline = mode->task[j].deadline;
+    }
+    else {
+        TASKS[j].period = 0;
+    }
+}
+
+#if TMAN_USE_ADMISSION
+
+/* Check a mode on its own: at the safe point no job of the old mode is
+ * left to interfere. The trial attributes are set with the scheduler
+ * suspended, so the dispatcher never runs on them. */
+static int mode_admit(const struct MODE *mode)
+{
+    static struct ATTRIBUTES saved[TMAN_MAX_TASKS];
+    int result;
+
+    vTaskSuspendAll();
+    DISPATCHER_LOCK();
+    for (int i = 0; i < task_id; i++){
+        attributes_save(i, &saved[i]);
+        mode_attributes(mode, i);
+    }
+#if TMAN_USE_AUTO_PRIORITY
+    priorities_assign();
+#endif
+    result = admission_test();
+    for (int i = 0; i < task_id; i++){
+        attributes_restore(i, &saved[i]);
+    }
+    DISPATCHER_UNLOCK();
+    xTaskResumeAll();
+
+    return result;
+}
+
+#endif /* TMAN_USE_ADMISSION */
+
+/* First hyperperiod boundary of the tasks in force after the current
+ * tick, 0 if the hyperperiod is too long to wait for */
+static int mode_next_boundary(void)
+{
+    int hyperperiod = task_hyperperiod(INT_MAX / 2);
+
+    if (hyperperiod == 0 || TMAN_TICK > INT_MAX / 2){
+        return 0;
+    }
+    return TMAN_TICK - (TMAN_TICK - release_origin) % hyperperiod + hyperperiod;
+}
+
+int TMAN_ModeChange(char name, int safe_point)
+{
+    int m = mode_lookup(name);
+
+    if (m < 0 || (safe_point != TMAN_MODE_IDLE && safe_point != TMAN_MODE_HYPERPERIOD)){
+        return TMAN_FAIL;
+    }
+
+#if TMAN_USE_ADMISSION
+    if (mode_admit(&MODES[m]) != TMAN_SUCCESS){
+        TMAN_PRINTF("TMAN: MODE (%c) REJECTED, TASK SET NOT SCHEDULABLE\n\r", name);
+        return TMAN_FAIL;
+    }
+#endif
+
+    taskENTER_CRITICAL();
+    mode_safe_point = safe_point;
+    mode_boundary = safe_point == TMAN_MODE_HYPERPERIOD ? mode_next_boundary() : 0;
+    mode_request_tick = TMAN_TICK;
+    mode_requested = m;
+    taskEXIT_CRITICAL();
+#if TMAN_USE_TICKLESS
+    dispatcher_wake();
+#endif
+    return TMAN_SUCCESS;
+}
+
+char TMAN_ModeCurrent(void)
+{
+    return mode_current < 0 ? 0 : MODES[mode_current].name;
+}
+
+/* Put mode m in force. Only called with no job pending, so no deadline
+ * check, deferred release or budget action of the old mode is left: every
+ * task starts over, the periodic ones released at their phase from now. */
+static void mode_switch(int m)
+{
+    release_origin = TMAN_TICK;
+
+    for (int i = 0; i < task_id; i++){
+        struct TASK *task = &TASKS[i];
+
+        mode_attributes(&MODES[m], i);
+        task->next_deadline = TMAN_NO_EVENT;
+        task->jitter_valid = 0;
+        task->skip_next = 0;
+        if (!task_registered(i)){
+            /* Stopped, activations still queued and budget left are
+             * dropped */
+            task->next_release = TMAN_NO_EVENT;
+            task->arrivals_seen = task->arrivals;
+#if TMAN_MAX_SERVERS > 0
+            if (task->server != NULL){
+                task->server->remaining = 0;
+            }
+#endif
+        }
+        else if (task->sporadic){
+            task->next_release = TMAN_NO_EVENT;
+            task->last_release = TMAN_TICK - task->period;
+        }
+        else {
+            task->next_release = next_release_after(task, TMAN_TICK - 1);
+        }
+        if (task->calendar_pos < 0){
+            task->calendar_pos = calendar_size;
+            CALENDAR[calendar_size++] = i;
+        }
+    }
+    calendar_rebuild();
+
+#if TMAN_USE_AUTO_PRIORITY
+    priorities_assign();
+#endif
+    priorities_apply();
+#if TMAN_USE_TIME_TRIGGERED
+    /* The table starts over at this tick, its first slot is due now */
+    tt_build();
+    if (tt_slots > 0){
+        tt_base = TMAN_TICK;
+        tt_next = 0;
+    }
+#endif
+
+    if (TMAN_TICK - mode_request_tick > mode_delay_max){
+        mode_delay_max = TMAN_TICK - mode_request_tick;
+    }
+    mode_changes++;
+    mode_current = m;
+    tman_log(LOG_DISPATCHER, LOG_MODE, MODES[m].name, TMAN_TICK);
+}
+
+/* Carry out a pending mode change if this tick is a safe point: no job
+ * pending and, for TMAN_MODE_HYPERPERIOD, the tick of a hyperperiod
+ * boundary (before any release in it; the tickless dispatcher wakes up for
+ * it). A boundary found busy, or passed, is skipped for the next one. */
+static void mode_dispatch(void)
+{
+    int m;
+
+    DISPATCHER_ENTER_CRITICAL();
+    m = mode_requested;
+    if (m >= 0 && PENDING == 0 && (mode_boundary == 0 || TMAN_TICK == mode_boundary)){
+        mode_requested = -1;
+    }
+    else {
+        if (m >= 0 && mode_boundary != 0 && TMAN_TICK >= mode_boundary){
+            mode_boundary = mode_next_boundary();
+        }
+        m = -1;
+    }
+    DISPATCHER_EXIT_CRITICAL();
+
+    if (m >= 0){
+        mode_switch(m);
+    }
+}
+
+#endif /* TMAN_MAX_MODES > 0 */
+
+#if TMAN_MAX_RESOURCES > 0
+
+/* Resource index of a resource name, -1 if there is none */
+static int resource_lookup(char name)
+{
+    for (int r = 0; r < resource_count; r++){
+        if (RESOURCES[r].name == name){
+            return r;
+        }
+    }
+    return -1;
+}
+
+int TMAN_ResourceAdd(char name)
+{
+    if (resource_count >= TMAN_MAX_RESOURCES || resource_lookup(name) >= 0){
+        return TMAN_FAIL;
+    }
+
+    memset(&RESOURCES[resource_count], 0, sizeof RESOURCES[resource_count]);
+    RESOURCES[resource_count].name = name;
+    RESOURCES[resource_count].ceiling = INT_MIN;
+    RESOURCES[resource_count].holder = -1;
+    return resource_count++;
+}
+
+int TMAN_ResourceUse(char resource, char name, int cs_us)
+{
+    int r = resource_lookup(resource);
+    int j = task_lookup(name);
+
+    if (r < 0 || j < 0 || cs_us < 0 || RESOURCES[r].holder >= 0){
+        return TMAN_FAIL;
+    }
+
+    task_mask_t users = RESOURCES[r].users;
+    int cs_saved = RESOURCES[r].cs_us[j];
+
+    RESOURCES[r].users |= TASK_BIT(j);
+    RESOURCES[r].cs_us[j] = cs_us;
+#if TMAN_USE_ADMISSION
+    if (admission_test() != TMAN_SUCCESS){
+        RESOURCES[r].users = users;
+        RESOURCES[r].cs_us[j] = cs_saved;
+        TMAN_PRINTF("TMAN: (%c) ON (%c) REJECTED, TASK SET NOT SCHEDULABLE\n\r", name, resource);
+        return TMAN_FAIL;
+    }
+#else
+    (void)users;
+    (void)cs_saved;
+#endif
+    RESOURCES[r].ceiling = resource_ceiling(r);
+    return TMAN_SUCCESS;
+}
+
+/* Ceilings of the resources from the attributes in force */
+static void resources_update(void)
+{
+    for (int r = 0; r < resource_count; r++){
+        RESOURCES[r].ceiling = resource_ceiling(r);
+    }
+}
+
+#if TMAN_USE_EDF
+
+/* System ceiling of the SRP: highest ceiling of the locked resources,
+ * INT_MIN if none is locked */
+static int resource_system_ceiling(void)
+{
+    int ceiling = INT_MIN;
+
+    for (int r = 0; r < resource_count; r++){
+        if (RESOURCES[r].holder >= 0 && RESOURCES[r].ceiling > ceiling){
+            ceiling = RESOURCES[r].ceiling;
+        }
+    }
+    return ceiling;
+}
+
+#endif
+
+/* Level a task runs at: its own, raised to the ceilings it holds */
+static int resource_level(int id)
+{
+    int level = task_level(id);
+
+    for (int h = 0; h < TASKS[id].locks; h++){
+        if (RESOURCES[TASKS[id].held[h]].ceiling > level){
+            level = RESOURCES[TASKS[id].held[h]].ceiling;
+        }
+    }
+    return level;
+}
+
+/* Kernel priority of a task after a lock or an unlock: the ceilings it
+ * holds, or its own priority (in EDF mode the band is ranked again with
+ * the new system ceiling). Called in a critical section. */
+static void resource_priority(int id)
+{
+#if TMAN_USE_EDF
+    (void)id;
+    edf_assign_priorities();
+#else
+    int priority = task_holds_resources(id) ? resource_level(id) :
+            task_demoted(id) ? TMAN_OVERRUN_PRIORITY : TASKS[id].priority;
+
+    if (TASKS[id].active_priority != priority){
+        TASKS[id].active_priority = priority;
+        vTaskPrioritySet(TASKS[id].handler, priority);
+    }
+#endif
+}
+
+/* Give back the innermost resource held by a task, in a critical section.
+ * The jobs it kept from starting are charged the blocking: released jobs
+ * handed over and not started, of tasks that would have preempted the
+ * holder but for this ceiling (the resources it still holds account for
+ * the others). */
+static void resource_release(int id)
+{
+    struct RESOURCE *res = &RESOURCES[TASKS[id].held[--TASKS[id].locks]];
+    uint32_t now = TMAN_TIMESTAMP();
+    int level = resource_level(id);
+
+    if (now - res->locked > res->held_max){
+        res->held_max = now - res->locked;
+    }
+    res->holder = -1;
+
+    for (task_mask_t mask = PENDING & ~TASK_BIT(id); mask != 0; mask &= mask - 1){
+        int k = mask_first(mask);
+        struct TASK *t = &TASKS[k];
+
+        if (t->in_job || t->dispatched == t->jobs_done || task_level(k) <= level || task_level(k) > res->ceiling){
+            continue;
+        }
+#if TMAN_USE_EDF
+        if ((PENDING & TASK_BIT(id)) && edf_deadline(k) >= edf_deadline(id)){
+            continue;
+        }
+#endif
+        /* Blocked from its release or from the lock, the later */
+        uint32_t release = t->release_stamp[t->jobs_done % TMAN_STATS_BACKLOG];
+        uint32_t since = (int32_t)(release - res->locked) > 0 ? release : res->locked;
+
+        t->blocked += now - since;
+    }
+}
+
+int TMAN_ResourceLock(char resource)
+{
+    int r = resource_lookup(resource);
+    int id = (int)(intptr_t)xTaskGetApplicationTaskTag(NULL) - 1;
+
+    if (r < 0 || id < 0 || !(RESOURCES[r].users & TASK_BIT(id)) || RESOURCES[r].holder == id){
+        return TMAN_FAIL;
+    }
+
+    taskENTER_CRITICAL();
+    /* Always free with ceilings, but for a task of the same priority time
+     * sliced with the holder: the holder goes on until it unlocks */
+    while (RESOURCES[r].holder >= 0){
+        taskEXIT_CRITICAL();
+        taskYIELD();
+        taskENTER_CRITICAL();
+    }
+    RESOURCES[r].holder = id;
+    RESOURCES[r].locked = TMAN_TIMESTAMP();
+    RESOURCES[r].locks++;
+    TASKS[id].held[TASKS[id].locks++] = r;
+    resource_priority(id);
+    taskEXIT_CRITICAL();
+
+    return TMAN_SUCCESS;
+}
+
+int TMAN_ResourceUnlock(char resource)
+{
+    int r = resource_lookup(resource);
+    int id = (int)(intptr_t)xTaskGetApplicationTaskTag(NULL) - 1;
+
+    /* The innermost resource of the caller only */
+    if (r < 0 || id < 0 || TASKS[id].locks == 0 || TASKS[id].held[TASKS[id].locks - 1] != r){
+        return TMAN_FAIL;
+    }
+
+    taskENTER_CRITICAL();
+    resource_release(id);
+    resource_priority(id);
+    taskEXIT_CRITICAL();
+
+    return TMAN_SUCCESS;
+}
+
+#endif /* TMAN_MAX_RESOURCES > 0 */
+
+void task_manager(void){
+
+    int released;
+
+#if TMAN_USE_BUDGET
+    budget_enforce();
+#endif
+
+#if TMAN_MAX_MODES > 0
+    /* Before the releases of this tick, so a new mode starts with them */
+    if (mode_requested >= 0){
+        mode_dispatch();
+    }
+#endif
+
+#if TMAN_USE_TIME_TRIGGERED
+    if (tt_slots > 0){
+        released = tt_dispatch();
+    }
+    else {
+        released = calendar_dispatch();
+    }
+#else
+    released = calendar_dispatch();
+#endif
+    if (SPORADIC != 0){
+        released |= sporadic_dispatch();
+    }
+
+#if TMAN_USE_EDF
+    /* New jobs change the deadline order; set the priorities before the
+     * jobs are handed over */
+    if (released){
+        edf_assign_priorities();
+    }
+#else
+    (void)released;
+#endif
+
+    /* Hand the released jobs to the tasks whose predecessors have no
+     * pending jobs, one notification per job; tasks with nothing left to
+     * hand over leave the dispatch list */
+    int k = 0;
+    precedence_waiting = 0;
+    while (k < dispatch_size){
+        int task = DISPATCH[k];
+
+        if ((TASKS[task].predecessors & PENDING) == 0){
+            while (TASKS[task].dispatched != TASKS[task].activations){
+#if TMAN_USE_ISR_DISPATCHER
+                /* The kernel switches to a woken task of higher priority
+                 * when the tick interrupt returns */
+                vTaskNotifyGiveFromISR(TASKS[task].handler, NULL);
+#else
+                xTaskNotifyGive(TASKS[task].handler);
+#endif
+                TASKS[task].dispatched++;
+            }
+            TASKS[task].dispatching = 0;
+            DISPATCH[k] = DISPATCH[--dispatch_size];
+            continue;
+        }
+        precedence_waiting++;
+        k++;
+    }
+
+}
+
+#if TMAN_USE_TICKLESS
+
+/* TMAN tick of the next calendar event, bounded so the dispatcher still
+ * wakes up once in a while when the calendar is empty */
+static int next_event_tick(void)
+{
+    int next = TMAN_TICK + TMAN_TICKLESS_MAX_SLEEP;
+
+#if TMAN_MAX_MODES > 0
+    /* A mode change awaiting a hyperperiod boundary is tried on it */
+    if (mode_requested >= 0 && mode_boundary > TMAN_TICK && mode_boundary < next){
+        next = mode_boundary;
+    }
+#endif
+
+#if TMAN_USE_TIME_TRIGGERED
+    if (tt_slots > 0){
+        if (tt_base + TT_TABLE[tt_next].tick < next){
+            next = tt_base + TT_TABLE[tt_next].tick;
+        }
+        return next;
+    }
+#endif
+    if (calendar_size > 0 && calendar_key(CALENDAR[0]) < next){
+        next = calendar_key(CALENDAR[0]);
+    }
+    return next;
+}
+
+/* Wake the dispatcher so it re-reads the calendar and the dispatch list */
+static void dispatcher_wake(void)
+{
+    if (TICK_HANDLER != NULL && xTaskGetCurrentTaskHandle() != TICK_HANDLER){
+        xTaskNotifyGive(TICK_HANDLER);
+    }
+}
+
+#if TMAN_USE_HIRES_TIME
+
+void TMAN_AlarmFromISR(BaseType_t *higher_priority_woken)
+{
+    if (TICK_HANDLER != NULL){
+        vTaskNotifyGiveFromISR(TICK_HANDLER, higher_priority_woken);
+    }
+}
+
+void task_tick_work(void *pvParam)
+{
+
+    uint32_t alarm;
+    uint32_t now;
+    uint32_t last = TMAN_TIMESTAMP();
+    const uint32_t start = last;
+    uint64_t elapsed = 0;   // timestamp units since the start, unwrapped
+
+    for(;;){
+        /* Arm the alarm for the next release or deadline check and sleep,
+         * unless the event is due already (checked after arming, so an
+         * alarm set too late is not waited for) */
+        alarm = start + ticks_to_stamp(next_event_tick());
+        TMAN_ALARM_SET(alarm);
+        if ((int32_t)(alarm - TMAN_TIMESTAMP()) > 0){
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        stats_request();
+
+        /* Woken by the alarm, or early when the calendar changed, a job
+         * completed or a sporadic task was activated. The sleeps are
+         * shorter than the timestamp wrap around. */
+        now = TMAN_TIMESTAMP();
+        elapsed += (uint32_t)(now - last);
+        last = now;
+        TMAN_TICK = (int)(elapsed * TICK_PERIOD_HZ / ((uint64_t)TMAN_TIMESTAMP_HZ * TASK_TICK_PERIOD));
+
+        // TASK HANDLING
+        task_manager();
+    }
+}
+
+#else
+
+void task_tick_work(void *pvParam)
+{
+
+    TickType_t xDelay;
+    const TickType_t xStartTime = xTaskGetTickCount();
+    const TickType_t xMaxDelay = (TickType_t)(TMAN_TICKLESS_MAX_SLEEP + 1) * TASK_TICK_PERIOD;
+
+    for(;;){
+        /* Sleep straight to the next release or deadline check (events
+         * already due wrap around past xMaxDelay and do not sleep) */
+        xDelay = xStartTime + (TickType_t)next_event_tick() * TASK_TICK_PERIOD - xTaskGetTickCount();
+        if (xDelay != 0 && xDelay <= xMaxDelay){
+            ulTaskNotifyTake(pdTRUE, xDelay);
+        }
+        stats_request();
+
+        /* Notified early when the calendar changed, a job completed or a
+         * sporadic task was activated */
+        TMAN_TICK = (xTaskGetTickCount() - xStartTime) / TASK_TICK_PERIOD;
+
+        // TASK HANDLING
+        task_manager();
+    }
+}
+
+#endif /* TMAN_USE_HIRES_TIME */
+
+#elif TMAN_USE_ISR_DISPATCHER
+
+/* Dispatch the TMAN ticks due, from the tick hook with the kernel
+ * interrupts masked. Kernel ticks the hook did not see (processed while
+ * the scheduler was suspended) are caught up here, and the dispatch waits
+ * while a task is changing the calendar. */
+static void tick_dispatch(void)
+{
+    TickType_t now = xTaskGetTickCountFromISR();
+
+    while (!dispatcher_locked && now - dispatcher_last >= (TickType_t)TASK_TICK_PERIOD){
+        dispatcher_last += TASK_TICK_PERIOD;
+        stats_request();
+
+        TMAN_TICK = TMAN_TICK+1;
+
+        // TASK HANDLING
+        task_manager();
+    }
+}
+
+#elif TMAN_USE_SIMULATION
+
+/* One TMAN tick, run by the simulator in place of the dispatcher task */
+void TMAN_SimTick(void)
+{
+    TMAN_TICK = TMAN_TICK+1;
+
+    // TASK HANDLING
+    task_manager();
+}
+
+#else
+
+void task_tick_work(void *pvParam)
+{
+
+    TickType_t xLastWakeTime;
+    const TickType_t xFrequency = TASK_TICK_PERIOD;
+    xLastWakeTime = xTaskGetTickCount();
+
+    for(;;){
+#if TMAN_USE_BUDGET
+        /* Sleep until the next TMAN tick, woken on the way by the tick hook
+         * to handle budget overruns */
+        for(;;){
+            TickType_t xDelay = xLastWakeTime + xFrequency - xTaskGetTickCount();
+
+            if (xDelay == 0 || xDelay > xFrequency){
+                break;
+            }
+            if (ulTaskNotifyTake(pdTRUE, xDelay) != 0){
+                budget_enforce();
+            }
+        }
+        xLastWakeTime += xFrequency;
+#else
+        vTaskDelayUntil( &xLastWakeTime, xFrequency );
+#endif
+        stats_request();
+
+        TMAN_TICK = TMAN_TICK+1;
+        //printf("TMAN_TICK = %d\n\r", TMAN_TICK);
+
+        // TASK HANDLING
+        task_manager();
+    }
+}
+
+#endif /* TMAN_USE_TICKLESS */
+
+void task_work(void *pvParam)
+{
+
+    struct TASK *working_task;
+    working_task =(struct TASK *)pvParam;
+
+    int i;
+    int IMAXCOUNT = 9999;
+    //int JMAXCOUNT = 99999999;
+
+    for(;;){
+        /* Wait for the release of the next job */
+        TMAN_TaskWaitPeriod();
+        job_start(working_task);
+
+        for(i=0; i<IMAXCOUNT; i++){
+            /*for(j=0; j<JMAXCOUNT; j++){
+
+            }*/
+        }
+
+        job_end(working_task);
+#if TMAN_MAX_RESOURCES > 0 && TMAN_CONSOLE_RESOURCE != 0 && !TMAN_USE_DEFERRED_LOG
+        /* The record goes straight to the console, shared with the other
+         * tasks */
+        int console = TMAN_ResourceLock(TMAN_CONSOLE_RESOURCE) == TMAN_SUCCESS;
+        tman_log(working_task - TASKS, LOG_JOB, working_task->name, TMAN_TICK);
+        if (console){
+            TMAN_ResourceUnlock(TMAN_CONSOLE_RESOURCE);
+        }
+#else
+        tman_log(working_task - TASKS, LOG_JOB, working_task->name, TMAN_TICK);
+#endif
+    }
+}
+
+#if TMAN_USE_SIMULATION
+
+/* What task_work() does around the work of a job, for the jobs the
+ * simulator plays */
+void TMAN_SimJobStart(int id)
+{
+    job_start(&TASKS[id]);
+}
+
+void TMAN_SimJobEnd(int id)
+{
+    job_end(&TASKS[id]);
+    tman_log(id, LOG_JOB, TASKS[id].name, TMAN_TICK);
+}
+
+void TMAN_SimTotals(struct TMAN_SIM_TOTALS *totals)
+{
+    memset(totals, 0, sizeof *totals);
+
+    for(int i = 0; i < task_id; i++){
+        struct JOB_STATS *stats = &TASKS[i].stats;
+
+        totals->activations += TASKS[i].activations;
+        totals->deadline_misses += TASKS[i].deadline_misses;
+        totals->jobs += stats->jobs;
+        for(int b = 0; b <= TMAN_STATS_BUCKETS; b++){
+            totals->histogram[b] += stats->histogram[b];
+        }
+
+        if (stats->jobs > 0 && TASKS[i].deadline > 0){
+            unsigned ratio = (uint64_t)stats->response_max * 1000 / ticks_to_stamp(TASKS[i].deadline);
+
+            if (ratio > totals->response_ratio_max){
+                totals->response_ratio_max = ratio;
+            }
+        }
+    }
+}
+
+#endif /* TMAN_USE_SIMULATION */
+
+#if TMAN_MAX_SERVERS > 0
+
+/* Run queued aperiodic jobs while budget is left. A job that was started
+ * runs to completion and is charged with its elapsed time (preemptions
+ * included), so an overrun only empties the budget. */
+static void server_serve(struct SERVER *server)
+{
+    struct SERVER_REQUEST request;
+
+    while (server->remaining > 0 && xQueueReceive(server->queue, &request, 0) == pdTRUE){
+        uint32_t start = TMAN_TIMESTAMP();
+        request.job(request.arg);
+        uint32_t end = TMAN_TIMESTAMP();
+
+        server->remaining = end - start < server->remaining ? server->remaining - (end - start) : 0;
+        stats_add(&server->response_min, &server->response_max, &server->response_sum, end - request.arrival, server->jobs);
+        server->jobs++;
+    }
+}
+
+void server_work(void *pvParam)
+{
+
+    struct TASK *server_task;
+    server_task = (struct TASK *)pvParam;
+    struct SERVER *server = server_task->server;
+
+    for(;;){
+        /* Woken by the dispatcher (releases) or, for a deferrable server,
+         * by a submission; the counters tell the releases apart */
+        task_wait(pdTRUE);
+
+        while (server_task->jobs_done != server_task->dispatched){
+            job_start(server_task);
+            server->remaining = server->budget;
+            server_serve(server);
+            if (server->type == TMAN_SERVER_POLLING){
+                server->remaining = 0;
+            }
+            job_end(server_task);
+            tman_log(server_task - TASKS, LOG_JOB, server_task->name, TMAN_TICK);
+        }
+
+        /* Budget kept from this period's release */
+        server_serve(server);
+    }
+}
+
+#endif /* TMAN_MAX_SERVERS > 0 */
@@ -0,0 +1,528 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN - Task Manager framework for FreeRTOS
+ *
+ * Public interface of the task manager. The implementation (tman.c) only
+ * depends on the FreeRTOS kernel API, so the same code is linked both in the
+ * PIC32 demo (mainSETRLedBlink.c) and in the Linux host build (Posix_GCC).
+ *
+ */
+
+#ifndef TMAN_H
+#define TMAN_H
+
+/* Kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Output used by TMAN messages. On the board stdout is redirected to the
+ * UART, the host build overrides it with a thread safe console print. */
+#ifndef TMAN_PRINTF
+#define TMAN_PRINTF printf
+#endif
+
+/* Size of the task table, fixed at build time */
+#ifndef TMAN_MAX_TASKS
+#define TMAN_MAX_TASKS 16
+#endif
+
+/* Static allocation: the TMAN tasks, the dispatcher, the logger and the
+ * server queues live in memory reserved at build time and TMAN takes
+ * nothing from the kernel heap. Needs configSUPPORT_STATIC_ALLOCATION,
+ * which FreeRTOSConfig.h turns on with it. */
+#ifndef TMAN_USE_STATIC_ALLOCATION
+#define TMAN_USE_STATIC_ALLOCATION configSUPPORT_STATIC_ALLOCATION
+#endif
+
+/* Stack depths (in words) of the tasks added with TMAN_TaskAdd() and
+ * TMAN_ServerAdd(), of the dispatcher and of the logger */
+#ifndef TMAN_STACK_SIZE
+#define TMAN_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+#ifndef TMAN_TICK_STACK_SIZE
+#define TMAN_TICK_STACK_SIZE TMAN_STACK_SIZE
+#endif
+#ifndef TMAN_LOG_STACK_SIZE
+#define TMAN_LOG_STACK_SIZE TMAN_STACK_SIZE
+#endif
+
+/* Tasks of TMAN_STACK_SIZE words the static stack pool holds, servers
+ * included. The pool is .bss reserved whether the tasks are added or
+ * not, so an application with fewer tasks than TMAN_MAX_TASKS sets it
+ * to the tasks it adds. */
+#ifndef TMAN_POOL_TASKS
+#define TMAN_POOL_TASKS TMAN_MAX_TASKS
+#endif
+
+/* Words of the static pool the task stacks are taken from, each task
+ * taking the depth it was added with */
+#ifndef TMAN_STACK_POOL
+#define TMAN_STACK_POOL (TMAN_POOL_TASKS * TMAN_STACK_SIZE)
+#endif
+
+/* Deferred logging: TMAN messages are queued in lock-free per-task rings
+ * and printed by a low priority logger task, keeping printf() and the
+ * UART off the real-time path. */
+#ifndef TMAN_USE_DEFERRED_LOG
+#define TMAN_USE_DEFERRED_LOG 1
+#endif
+
+/* Records per log ring (power of two) */
+#ifndef TMAN_LOG_SIZE
+#define TMAN_LOG_SIZE 8
+#endif
+
+/* Logger task priority and polling period (in system ticks) */
+#ifndef TMAN_LOG_PRIORITY
+#define TMAN_LOG_PRIORITY tskIDLE_PRIORITY
+#endif
+#ifndef TMAN_LOG_PERIOD
+#define TMAN_LOG_PERIOD 10
+#endif
+
+/* Period of the TMAN_TaskStats() printout by the dispatcher, in ms of
+ * wall clock time (also the window of the utilization figures). 0 leaves
+ * it to the application. */
+#ifndef TMAN_STATS_PERIOD_MS
+#define TMAN_STATS_PERIOD_MS 1000
+#endif
+
+/* Tickless dispatcher: instead of waking every TMAN tick, the tick task
+ * sleeps until the next release or deadline check in the calendar, or
+ * until notified of a change. */
+#ifndef TMAN_USE_TICKLESS
+#define TMAN_USE_TICKLESS 0
+#endif
+
+/* High resolution time base: the TMAN tick period given to TMAN_Init() is
+ * in microseconds instead of kernel ticks (1: periods, phases and deadlines
+ * in microseconds). TMAN time is read from TMAN_TIMESTAMP() and the
+ * dispatcher, always tickless, is woken by an alarm: FreeRTOSConfig.h maps
+ * TMAN_ALARM_SET(stamp) to a timer compare that fires when TMAN_TIMESTAMP()
+ * reaches stamp, and its interrupt calls TMAN_AlarmFromISR(). TMAN_TICK
+ * is an int, so with 1 us ticks a run lasts at most 35 minutes. */
+#ifndef TMAN_USE_HIRES_TIME
+#define TMAN_USE_HIRES_TIME 0
+#endif
+#if TMAN_USE_HIRES_TIME
+#undef TMAN_USE_TICKLESS
+#define TMAN_USE_TICKLESS 1
+#endif
+
+/* Dispatcher in the kernel tick hook: the releases and deadline checks of
+ * every TMAN tick run in TMAN_TickHook(), in the tick interrupt, instead of
+ * in a dispatcher task, which saves its stack and two context switches per
+ * TMAN tick. Only interrupt safe kernel calls are made there, so it does
+ * not go with the tickless dispatcher, budgets, EDF, immediate logging,
+ * the time-triggered table with modes, or the ABORT and RESTART miss
+ * policies; the priorities of a mode change are
+ * taken over by each task when it wakes up for its next job. */
+#ifndef TMAN_USE_ISR_DISPATCHER
+#define TMAN_USE_ISR_DISPATCHER 0
+#endif
+
+/* Schedule simulator build (Tools/tman_sim.c): TMAN runs on a simulated
+ * kernel (Tools/sim) and simulated time. There is no dispatcher task, the
+ * simulator calls TMAN_SimTick() every TMAN tick and marks the start and
+ * end of the jobs of the tasks it plays; the release, precedence and
+ * deadline handling are the same code as on the board. Logging is
+ * immediate, and budgets, servers and the tickless and tick hook
+ * dispatchers are left out. */
+#ifndef TMAN_USE_SIMULATION
+#define TMAN_USE_SIMULATION 0
+#endif
+
+/* Longest tickless sleep (in TMAN ticks) when nothing is scheduled. With
+ * the high resolution time base it must stay below the wrap around time of
+ * TMAN_TIMESTAMP(). */
+#ifndef TMAN_TICKLESS_MAX_SLEEP
+#if TMAN_USE_HIRES_TIME
+#define TMAN_TICKLESS_MAX_SLEEP 100000
+#else
+#define TMAN_TICKLESS_MAX_SLEEP 100
+#endif
+#endif
+
+/* Time-triggered mode: the releases and deadline checks of a whole
+ * hyperperiod are laid out once in a table (rebuilt when a task is
+ * registered or modified) and the dispatcher only walks it. Task sets whose
+ * hyperperiod or table do not fit the limits below, or with sporadic tasks,
+ * use the calendar. */
+#ifndef TMAN_USE_TIME_TRIGGERED
+#define TMAN_USE_TIME_TRIGGERED 0
+#endif
+#ifndef TMAN_TT_TABLE_SIZE
+#define TMAN_TT_TABLE_SIZE 64         // ticks with events per hyperperiod
+#endif
+#ifndef TMAN_TT_MAX_HYPERPERIOD
+#define TMAN_TT_MAX_HYPERPERIOD 1000  // TMAN ticks
+#endif
+
+/* EDF mode: at every release, and when a job of a backlog completes, the
+ * priorities of the tasks with pending jobs are set from their absolute
+ * deadlines, earliest on top, and the registered priorities are ignored. */
+#ifndef TMAN_USE_EDF
+#define TMAN_USE_EDF 0
+#endif
+
+/* Automatic priorities: deadline monotonic (rate monotonic when the
+ * deadlines equal the periods), the registered priorities are ignored */
+#ifndef TMAN_USE_AUTO_PRIORITY
+#define TMAN_USE_AUTO_PRIORITY 0
+#endif
+
+/* Admission control: registering a task or changing its period, phase or
+ * WCET fails (and changes nothing) when the task set would no longer be
+ * schedulable. Exact response time analysis with fixed priorities, the
+ * density test with EDF; the wait of a job for its predecessors counts as
+ * release jitter (their response times, their deadlines with EDF). */
+#ifndef TMAN_USE_ADMISSION
+#define TMAN_USE_ADMISSION 0
+#endif
+
+/* Priority band of the TMAN tasks for EDF and automatic priorities.
+ * Distinct deadlines take distinct priorities; once the band is used up
+ * the later deadlines share its lowest priority. */
+#ifndef TMAN_PRIORITY_MIN
+#define TMAN_PRIORITY_MIN (tskIDLE_PRIORITY + 1)
+#endif
+#ifndef TMAN_PRIORITY_MAX
+#define TMAN_PRIORITY_MAX (configMAX_PRIORITIES - 2)
+#endif
+
+/* Sporadic tasks: an activation closer than the minimum inter-arrival time
+ * to the previous release is counted, and with TMAN_SPORADIC_DEFER its
+ * release is postponed until the bound is met (otherwise it is released
+ * at once, which voids the admission analysis) */
+#ifndef TMAN_SPORADIC_DEFER
+#define TMAN_SPORADIC_DEFER 1
+#endif
+
+/* Execution time budgets: a job running past the WCET of its task
+ * (TMAN_TaskSetWCET) is caught at the next kernel tick or task switch and
+ * handled by the dispatcher as TMAN_OVERRUN_POLICY says. Needs
+ * TMAN_TickHook() in the kernel tick hook; FreeRTOSConfig.h turns
+ * configUSE_TICK_HOOK on with it. */
+#ifndef TMAN_USE_BUDGET
+#define TMAN_USE_BUDGET 0
+#endif
+
+/* Overrun policies:
+ *   COUNT   : only counted (and logged)
+ *   DEMOTE  : the job completes at TMAN_OVERRUN_PRIORITY
+ *   SUSPEND : the job is suspended until the next release of its task,
+ *             which gives it one more budget */
+#define TMAN_OVERRUN_COUNT      0
+#define TMAN_OVERRUN_DEMOTE     1
+#define TMAN_OVERRUN_SUSPEND    2
+
+#ifndef TMAN_OVERRUN_POLICY
+#define TMAN_OVERRUN_POLICY TMAN_OVERRUN_COUNT
+#endif
+#ifndef TMAN_OVERRUN_PRIORITY
+#define TMAN_OVERRUN_PRIORITY tskIDLE_PRIORITY
+#endif
+
+/* Deadline miss policies (TMAN_TaskSetMissPolicy()):
+ *   CONTINUE : the late job goes on, the miss is only counted
+ *   ABORT    : the late job is aborted, the jobs released after it still run
+ *   SKIP     : the late job goes on and the next release is skipped
+ *   RESTART  : the task starts over with all its pending jobs dropped
+ * ABORT and RESTART delete and re-create the kernel task, so a job that may
+ * be late must not hold a lock (a mutex, the printf() lock); the TMAN
+ * resources it holds are given back. They need TMAN_USE_STATIC_ALLOCATION
+ * and the task level dispatcher. */
+#define TMAN_MISS_CONTINUE      0
+#define TMAN_MISS_ABORT         1
+#define TMAN_MISS_SKIP          2
+#define TMAN_MISS_RESTART       3
+
+/* Aperiodic servers: TMAN tasks with a budget (execution time per period)
+ * that run the aperiodic jobs submitted by tasks or ISRs, replenished at
+ * every release of the server. 0 leaves the servers out. */
+#ifndef TMAN_MAX_SERVERS
+#define TMAN_MAX_SERVERS 1
+#endif
+
+/* Aperiodic jobs queued per server */
+#ifndef TMAN_SERVER_QUEUE_SIZE
+#define TMAN_SERVER_QUEUE_SIZE 8
+#endif
+
+/* Server types:
+ *   POLLING    : serves its queue when released; budget left unused when the
+ *                queue empties is lost until the next period
+ *   DEFERRABLE : keeps its budget for the whole period, jobs arriving later
+ *                in the period are served at once */
+#define TMAN_SERVER_POLLING     0
+#define TMAN_SERVER_DEFERRABLE  1
+
+/* Operating modes: named sets of tasks with their attributes, switched as
+ * a whole by the dispatcher at a safe point. 0 leaves the modes out. */
+#ifndef TMAN_MAX_MODES
+#define TMAN_MAX_MODES 4
+#endif
+
+/* Mode change safe points:
+ *   IDLE        : first TMAN tick with no job pending, before its releases
+ *   HYPERPERIOD : same, exactly on the tick a hyperperiod of the old mode
+ *                 starts (its table runs to the end), the next boundary
+ *                 if that one is busy; any idle instant when the
+ *                 hyperperiod is too long to wait for */
+#define TMAN_MODE_IDLE          0
+#define TMAN_MODE_HYPERPERIOD   1
+
+/* Shared resources locked with priority ceilings (immediate priority
+ * ceiling, the Stack Resource Policy in EDF mode). 0 leaves them out. */
+#ifndef TMAN_MAX_RESOURCES
+#define TMAN_MAX_RESOURCES 4
+#endif
+
+/* Resource held by a task while it prints its job record, when the log is
+ * not deferred and the tasks share the console (the UART behind printf);
+ * 0 for none. Tasks that do not use it print unguarded. */
+#ifndef TMAN_CONSOLE_RESOURCE
+#define TMAN_CONSOLE_RESOURCE 0
+#endif
+
+/* High resolution timestamp of the job statistics and of the trace: a free
+ * running 32 bit counter and its rate. The kernel tick is the fallback,
+ * FreeRTOSConfig.h plugs in the PIC32 core timer or the host clock. */
+#ifndef TMAN_TIMESTAMP
+#define TMAN_TIMESTAMP() ((uint32_t)xTaskGetTickCount())
+#define TMAN_TIMESTAMP_HZ ((uint32_t)configTICK_RATE_HZ)
+#endif
+
+/* Response time histogram buckets, each a fraction of the deadline (one
+ * more bucket counts the jobs that finished past it) */
+#ifndef TMAN_STATS_BUCKETS
+#define TMAN_STATS_BUCKETS 8
+#endif
+
+/* Release timestamps kept per task, so late jobs of a backlog are still
+ * timed against their own release */
+#ifndef TMAN_STATS_BACKLOG
+#define TMAN_STATS_BACKLOG 4
+#endif
+
+/* Binary event trace (tman_trace.h): job releases, starts, completions,
+ * preemptions and deadline misses are recorded in a RAM buffer and
+ * streamed in frames by the logger task. Enabled in FreeRTOSConfig.h,
+ * which also installs the task switch hooks; needs TMAN_USE_DEFERRED_LOG. */
+#ifndef TMAN_USE_TRACE
+#define TMAN_USE_TRACE 0
+#endif
+
+/* Records in the trace buffer (power of two) */
+#ifndef TMAN_TRACE_SIZE
+#define TMAN_TRACE_SIZE 64
+#endif
+
+/* Raw output of the trace frames, same channel as TMAN_PRINTF by default */
+#ifndef TMAN_TRACE_WRITE
+#define TMAN_TRACE_WRITE(data, len) fwrite((data), 1, (len), stdout)
+#endif
+
+/* Return codes */
+#define TMAN_SUCCESS  0
+#define TMAN_FAIL    -1
+
+extern int TASK_TICK_PERIOD; // TICK TASK PERIOD
+extern int TMAN_TICK;        // TMAN TICK COUNTER
+
+/*
+ * Prototypes
+ */
+void TMAN_Init(int TMAN_TICK_PERIOD_VALUE, int N_TASKS);
+void TMAN_Close(void);
+int TMAN_TaskAdd(char name);
+/* precedence_constraints: ids of the predecessor tasks, ended by -1 (NULL
+ * for none). Registration fails if it would close a precedence cycle, and
+ * on the attributes TMAN_TASK_TABLE() rejects at build time (as does
+ * TMAN_ModeTask()). */
+int TMAN_TaskRegisterAttributes(char name, int priority, int period, int phase, int deadline, int precedence_constraints[]);
+void TMAN_TaskWaitPeriod(void);
+void TMAN_TaskStats(void);
+
+/* TMAN_TaskAdd() with a stack depth (in words) for the task. Fails when
+ * the static stack pool has not enough words left. */
+int TMAN_TaskAddStack(char name, int stack_size);
+
+/*
+ * Constant task table: the whole task set described once, checked by the
+ * compiler and kept in flash, then added and registered in one pass by
+ * TMAN_TaskTableInit(). The tasks are listed with an X-macro,
+ *
+ *   #define DEMO_TASKS(TASK) \
+ *       TASK(A, tskIDLE_PRIORITY + 3, 2, 0, 2, TMAN_AFTER(F)) \
+ *       TASK(B, tskIDLE_PRIORITY + 3, 1, 0, 1, TMAN_NONE) \
+ *       ...
+ *
+ *   TMAN_TASK_TABLE(demo_tasks, DEMO_TASKS);
+ *   TMAN_TaskTableInit(demo_tasks, TMAN_TABLE_SIZE(demo_tasks));
+ *
+ * TASK(name, priority, period, phase, deadline, predecessors): the name is
+ * written as an identifier (A for task 'A'), the predecessors are TMAN_NONE
+ * or TMAN_AFTER() of tasks of the same table joined by '|'. The build fails
+ * on a name of more than one character, an unknown predecessor, a task
+ * that precedes itself, a period or deadline not positive, a deadline
+ * longer than the period, a phase negative or not shorter than the
+ * period (the time-triggered table repeats from its first hyperperiod and
+ * could not delay a first release), a priority not below the dispatcher
+ * or more than TMAN_MAX_TASKS tasks. Precedence cycles through
+ * several tasks are rejected by TMAN_TaskTableInit(). One table per source
+ * file (the TMAN_ID_<name> constants are shared).
+ */
+struct TMAN_TASK_CONFIG {
+    char name;
+    int priority;
+    int period;            // TMAN ticks
+    int phase;             // TMAN ticks
+    int deadline;          // TMAN ticks
+    uint64_t predecessors; // bit i set: task i of the table
+};
+
+#define TMAN_NONE           ((uint64_t)0)
+#define TMAN_AFTER(name)    ((uint64_t)1 << TMAN_ID_##name)
+#define TMAN_TABLE_SIZE(table) ((int)(sizeof (table) / sizeof (table)[0]))
+
+#define TMAN_TABLE_ID_(name, priority, period, phase, deadline, predecessors) \
+    TMAN_ID_##name,
+#define TMAN_TABLE_CHECK_(name, priority, period, phase, deadline, predecessors) \
+    _Static_assert(sizeof #name == 2, "TMAN task " #name ": name of one character"); \
+    _Static_assert((period) > 0 && (deadline) > 0 && (deadline) <= (period), \
+            "TMAN task " #name ": period and deadline positive, deadline not longer than the period"); \
+    _Static_assert((phase) >= 0 && (phase) < (period), "TMAN task " #name ": phase negative or not shorter than the period"); \
+    _Static_assert((priority) < configMAX_PRIORITIES - 1, "TMAN task " #name ": priority of the dispatcher or above"); \
+    _Static_assert(((predecessors) & TMAN_AFTER(name)) == 0, "TMAN task " #name ": precedes itself");
+#define TMAN_TABLE_ENTRY_(name, priority, period, phase, deadline, predecessors) \
+    { #name[0], (priority), (period), (phase), (deadline), (predecessors) },
+
+#define TMAN_TASK_TABLE(table, TASKS) \
+    enum { TASKS(TMAN_TABLE_ID_) TMAN_TABLE_SIZE_##table }; \
+    _Static_assert(TMAN_TABLE_SIZE_##table <= TMAN_MAX_TASKS && TMAN_TABLE_SIZE_##table <= 64, \
+            "TMAN task table " #table ": more than TMAN_MAX_TASKS tasks"); \
+    _Static_assert(!TMAN_USE_STATIC_ALLOCATION || TMAN_TABLE_SIZE_##table * TMAN_STACK_SIZE <= TMAN_STACK_POOL, \
+            "TMAN task table " #table ": more stacks than TMAN_STACK_POOL holds"); \
+    TASKS(TMAN_TABLE_CHECK_) \
+    static const struct TMAN_TASK_CONFIG table[] = { TASKS(TMAN_TABLE_ENTRY_) }
+
+/* Add and register the n tasks of a table. Fails if they do not all fit
+ * (TMAN_Init() count), a name is taken, the precedences close a cycle or,
+ * with admission control, the task set is not schedulable; no task of the
+ * table is registered then. */
+int TMAN_TaskTableInit(const struct TMAN_TASK_CONFIG *table, int n);
+/* Same checks as the registration, with the other attributes kept */
+int taskModifyPeriod(char name, int period);
+int taskModifyPhase(char name, int phase);
+
+/* Sporadic task: released on demand by TMAN_TaskActivate(), at most once
+ * every min_interarrival TMAN ticks (its period for the analysis). The
+ * activation is picked up by the dispatcher at its next TMAN tick, or at
+ * once in tickless mode. Activations fail while the task is stopped by the
+ * mode in force. */
+int TMAN_TaskRegisterSporadic(char name, int priority, int min_interarrival, int deadline, int precedence_constraints[]);
+int TMAN_TaskActivate(char name);
+int TMAN_TaskActivateFromISR(char name, BaseType_t *higher_priority_woken);
+
+/* Worst-case execution time of a task in microseconds, used by the
+ * admission control (tasks without one count with their largest observed
+ * execution time) */
+int TMAN_TaskSetWCET(char name, int wcet_us);
+
+/* Deadline miss policy of a task (TMAN_MISS_*, CONTINUE when not set). A
+ * server, or any task with TMAN_USE_ISR_DISPATCHER, takes CONTINUE or SKIP
+ * only. */
+int TMAN_TaskSetMissPolicy(char name, int policy);
+
+/* (m,k)-firm constraint: at least m of any k consecutive deadlines of the
+ * task met (1 <= m <= k <= 32). Every window of k deadlines that breaks it
+ * is counted and logged; k = 0 removes the constraint. */
+int TMAN_TaskSetFirm(char name, int m, int k);
+
+#if TMAN_MAX_SERVERS > 0
+/* Add an aperiodic server task (TMAN_SERVER_* type). Its priority, period,
+ * phase and deadline are registered with TMAN_TaskRegisterAttributes() as
+ * for any task; the budget is its WCET (TMAN_TaskSetWCET() changes it). */
+int TMAN_ServerAdd(char name, int type, int budget_us);
+
+/* Queue an aperiodic job job(arg) on a server. Fails when the queue is
+ * full (the job is counted as dropped). The FromISR variant sets
+ * *higher_priority_woken for portYIELD_FROM_ISR(). */
+int TMAN_ServerSubmit(char name, void (*job)(void *), void *arg);
+int TMAN_ServerSubmitFromISR(char name, void (*job)(void *), void *arg, BaseType_t *higher_priority_woken);
+#endif
+
+#if TMAN_MAX_MODES > 0
+/* Add an empty mode, then list the tasks that run in it with
+ * TMAN_ModeTask() (tasks already added, with their attributes in the mode;
+ * a sporadic task takes the period as its minimum inter-arrival time and
+ * no phase). Tasks not listed are stopped while the mode is in force. */
+int TMAN_ModeAdd(char mode);
+int TMAN_ModeTask(char mode, char name, int priority, int period, int phase, int deadline);
+
+/* Request a change to a mode at the next TMAN_MODE_* safe point; a later
+ * request replaces a pending one. With admission control the mode is
+ * checked first. Phases count from the tick the mode comes into force;
+ * taskModify*() change the tasks in force, not the mode. */
+int TMAN_ModeChange(char mode, int safe_point);
+
+/* Mode in force, 0 before the first change */
+char TMAN_ModeCurrent(void);
+#endif
+
+#if TMAN_MAX_RESOURCES > 0
+/* Add a shared resource, then declare the tasks that lock it with
+ * TMAN_ResourceUse(), each with its longest critical section on it in
+ * microseconds (for the admission control). The ceiling of a resource is
+ * the highest priority of its tasks (shortest deadline in EDF mode),
+ * derived again whenever the priorities change. With admission control a
+ * use that makes the task set not schedulable is rejected. */
+int TMAN_ResourceAdd(char resource);
+int TMAN_ResourceUse(char resource, char name, int cs_us);
+
+/* Lock and unlock a resource from a task that uses it, nested locks in
+ * reverse order. The task runs at the ceiling while it holds the resource
+ * (in EDF mode, jobs that may not preempt the ceiling wait), so a job is
+ * blocked at most once, for one critical section of a lower priority
+ * task, before it starts; TMAN_TaskStats() reports the blocking measured.
+ * A task must not wait for its next job holding a resource. */
+int TMAN_ResourceLock(char resource);
+int TMAN_ResourceUnlock(char resource);
+#endif
+
+/* Kernel task switch hooks (traceTASK_SWITCHED_IN/OUT in FreeRTOSConfig.h) */
+void TMAN_TraceSwitchedIn(void *tag);
+void TMAN_TraceSwitchedOut(void *tag);
+
+/* Kernel tick hook (vApplicationTickHook), checks the budgets or, with
+ * TMAN_USE_ISR_DISPATCHER, dispatches the TMAN ticks */
+void TMAN_TickHook(void);
+
+#if TMAN_USE_HIRES_TIME
+/* Interrupt of the TMAN_ALARM_SET() timer compare: wakes the dispatcher */
+void TMAN_AlarmFromISR(BaseType_t *higher_priority_woken);
+#endif
+
+#if TMAN_USE_SIMULATION
+/* Schedule simulator: one TMAN tick (at the simulated time of the tick),
+ * and the start and end of a job of task 'id' (at the simulated times the
+ * job starts running and completes). TMAN_SimTotals() adds up the
+ * statistics of all the tasks. */
+struct TMAN_SIM_TOTALS {
+    unsigned activations;     // released jobs
+    unsigned deadline_misses;
+    unsigned jobs;            // completed jobs measured
+    unsigned histogram[TMAN_STATS_BUCKETS + 1]; // response / deadline
+    unsigned response_ratio_max; // largest response / deadline (1/1000)
+};
+
+void TMAN_SimTick(void);
+void TMAN_SimJobStart(int id);
+void TMAN_SimJobEnd(int id);
+void TMAN_SimTotals(struct TMAN_SIM_TOTALS *totals);
+#endif
+
+#endif /* TMAN_H */
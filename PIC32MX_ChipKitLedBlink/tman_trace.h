@@ -0,0 +1,44 @@
+/*
+ * Rodrigo Santos , nº mec 89180
+ * Rui Santos, nº mec 89293
+ *
+ * TMAN binary event trace format
+ *
+ * Shared by TMAN (tman.c), which streams the trace, and the host decoder
+ * (Tools/tman_trace.c). No kernel includes here.
+ *
+ * The trace is a byte stream of frames, which may be interleaved with
+ * plain text on the same UART:
+ *
+ *   SYNC0 SYNC1 <n> <n records> <checksum>
+ *
+ *   record   : time[4] (little endian) event[1] task[1]
+ *   checksum : two's complement of the byte sum of <n> and the records
+ *
+ * Times are in the unit given by the last TMAN_TRACE_CLOCK record
+ * (counts per second, sent when the trace starts).
+ *
+ */
+
+#ifndef TMAN_TRACE_H
+#define TMAN_TRACE_H
+
+/* Frame delimiters and sizes */
+#define TMAN_TRACE_SYNC0        0xA5
+#define TMAN_TRACE_SYNC1        0x5A
+#define TMAN_TRACE_RECORD_SIZE  6
+#define TMAN_TRACE_FRAME_MAX    32     // records per frame
+
+/* Events */
+#define TMAN_TRACE_CLOCK        0      // time field: timestamp counts per second
+#define TMAN_TRACE_NAME         1      // time field: name of task <task>
+#define TMAN_TRACE_RELEASE      2      // job released
+#define TMAN_TRACE_START        3      // job starts executing
+#define TMAN_TRACE_END          4      // job completed
+#define TMAN_TRACE_PREEMPT      5      // running job switched out
+#define TMAN_TRACE_RESUME       6      // preempted job switched back in
+#define TMAN_TRACE_MISS         7      // deadline miss
+#define TMAN_TRACE_OVERRUN      8      // job ran past its budget
+#define TMAN_TRACE_ABORT        9      // pending job dropped by the miss policy
+
+#endif /* TMAN_TRACE_H */